@@ -0,0 +1,596 @@
+/*
+ * v8easy ̃x`}[N
+ *
+ * v8easy_bench [--out {file}] [--filter {Öꕔ}] [--scale {񐔂̔{}] [--soak { ( 10000000)}]
+ * ʂ JSON ŏo (--out ΕWo) ̂ŁA[XƂɕׂĔׂ
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "v8easy.h"
+
+#ifdef _WIN32
+	#include <psapi.h>
+#endif
+
+using argument = v8easy::argument;
+using clock_type = std::chrono::steady_clock;
+
+struct bench_result {
+	std::string name;
+	uint64_t iterations = 0;	// 1̌vŉ񂵂 (ops_per_iteration O)
+	double ns_per_op = 0;		// v̐^񒆂̒l
+	double min_ns_per_op = 0;
+	size_t bytes = 0;			// 1ŏoCg (0 Ȃ MB/s ͏oȂ)
+	std::vector<std::pair<std::string, double>> extra;
+};
+
+class bench_runner {
+	std::string filter;
+	double scale = 1.0;
+	static const int rounds = 5;
+
+public:
+	std::vector<bench_result> results;
+
+	bench_runner(const std::string& filter, double scale) : filter(filter), scale(scale) {}
+
+	bool enabled(const std::string& name) const {
+		return filter.empty() || std::string::npos != name.find(filter);
+	}
+
+	/*
+	 * body  iterations ĂԂ̂ rounds 1񂠂̎Ԃo
+	 *
+	 * body 1 ops ̏鎞 (js ̃[vŉĂԎƂ) ops Ŋ
+	 * nh܂葱Ȃ悤1EhƂ v8::HandleScope J
+	 */
+	bench_result* measure(v8::Isolate* isolate, const std::string& name, uint64_t iterations, const std::function<void()>& body, size_t bytes = 0, uint64_t ops = 1) {
+		if (!enabled(name)) return nullptr;
+		iterations = std::max<uint64_t>(1, static_cast<uint64_t>(iterations * scale));
+
+		// 1ڂ JIT LbV߂邾
+		{
+			v8::HandleScope handle_scope(isolate);
+			body();
+		}
+		std::vector<double> samples;
+		for (int round = 0; round < rounds; ++round) {
+			v8::HandleScope handle_scope(isolate);
+			auto start = clock_type::now();
+			for (uint64_t i = 0; i < iterations; ++i)
+				body();
+			std::chrono::duration<double, std::nano> elapsed = clock_type::now() - start;
+			samples.push_back(elapsed.count() / static_cast<double>(iterations * ops));
+		}
+		std::sort(samples.begin(), samples.end());
+
+		bench_result result;
+		result.name = name;
+		result.iterations = iterations;
+		result.ns_per_op = samples[samples.size() / 2];
+		result.min_ns_per_op = samples.front();
+		result.bytes = bytes;
+		results.push_back(result);
+		std::cerr << name << ": " << result.ns_per_op << " ns/op" << std::endl;
+		return &results.back();
+	}
+
+	// 1񂾂̂͌vς݂̒l̂܂ܓ
+	bench_result* record(const std::string& name, const std::vector<std::pair<std::string, double>>& extra) {
+		if (!enabled(name)) return nullptr;
+		bench_result result;
+		result.name = name;
+		result.extra = extra;
+		results.push_back(result);
+		std::cerr << name << std::endl;
+		return &results.back();
+	}
+
+	std::string json() const {
+		std::ostringstream out;
+		out.precision(6);
+		out << std::fixed;
+		out << "{\n\t\"v8\": \"" << v8::V8::GetVersion() << "\",\n";
+#if defined(__clang__)
+		out << "\t\"compiler\": \"clang " << __clang_major__ << "." << __clang_minor__ << "\",\n";
+#elif defined(__GNUC__)
+		out << "\t\"compiler\": \"gcc " << __GNUC__ << "." << __GNUC_MINOR__ << "\",\n";
+#elif defined(_MSC_VER)
+		out << "\t\"compiler\": \"msvc " << _MSC_VER << "\",\n";
+#endif
+		out << "\t\"timestamp\": " << std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count() << ",\n";
+		out << "\t\"results\": [";
+		for (size_t i = 0; i < results.size(); ++i) {
+			auto& result = results[i];
+			out << (i ? ",\n" : "\n") << "\t\t{ \"name\": \"" << result.name << "\"";
+			if (result.iterations) {
+				out << ", \"iterations\": " << result.iterations
+					<< ", \"ns_per_op\": " << result.ns_per_op
+					<< ", \"min_ns_per_op\": " << result.min_ns_per_op;
+			}
+			if (result.bytes && result.ns_per_op > 0)
+				out << ", \"bytes\": " << result.bytes << ", \"mb_per_s\": " << (result.bytes / (1024.0 * 1024.0)) / (result.ns_per_op / 1e9);
+			for (auto& extra : result.extra)
+				out << ", \"" << extra.first << "\": " << extra.second;
+			out << " }";
+		}
+		out << "\n\t]\n}\n";
+		return out.str();
+	}
+};
+
+// vZX̏풓 (Ȃ 0)
+static size_t resident_bytes() {
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return counters.WorkingSetSize;
+	return 0;
+#else
+	size_t pages = 0, resident = 0;
+	std::ifstream statm("/proc/self/statm");
+	if (!(statm >> pages >> resident)) return 0;
+	return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+static size_t heap_used(v8::Isolate* isolate) {
+	v8::HeapStatistics heap;
+	isolate->GetHeapStatistics(&heap);
+	return heap.used_heap_size();
+}
+
+// js sĒl炤 (Ăԑ v8::HandleScope ƃReLXgɓĂ)
+static v8::Local<v8::Value> evaluate(v8::Isolate* isolate, const std::string& source) {
+	auto context = isolate->GetCurrentContext();
+	auto script = v8::Script::Compile(context, v8easy::as<v8::String>(v8easy::to_v8(isolate, source))).ToLocalChecked();
+	return script->Run(context).ToLocalChecked();
+}
+
+//  bytes oCg JSON (IuWFNg̔z) 
+static std::string make_json(size_t bytes) {
+	std::string json = "[";
+	for (size_t i = 0; json.size() < bytes; ++i) {
+		if (1 < json.size()) json += ",";
+		json += "{\"id\":" + std::to_string(i) + ",\"name\":\"item " + std::to_string(i)
+			+ "\",\"tags\":[\"a\",\"b\",\"c\"],\"value\":" + std::to_string(i * 0.5) + ",\"ok\":" + (i % 2 ? "true" : "false") + "}";
+	}
+	return json + "]";
+}
+
+static std::string size_name(size_t bytes) {
+	if (bytes >= 1024 * 1024) return std::to_string(bytes / (1024 * 1024)) + "MB";
+	return std::to_string(bytes / 1024) + "KB";
+}
+
+// set<֐>() œo^ (V8EASY_FAST_API  1 ȂœKꂽ js 璼ڌĂ΂)
+static double fast_add(double x, double y) {
+	return x + y;
+}
+
+static void write_file(const std::filesystem::path& path, const std::string& data) {
+	std::ofstream(path, std::ios::out | std::ios::binary | std::ios::trunc) << data;
+}
+
+int main(int argc, char* argv[]) {
+	std::string outFile, filter;
+	double scale = 1.0;
+	// Ԃ͊̕ 1000 (1񂠂萔 s Ȃ̂Ő\bA} --soak Ō炷)
+	uint64_t soak = 10000000;
+	for (int i = 1; i + 1 < argc; i += 2) {
+		std::string option = argv[i];
+		if ("--out" == option) outFile = argv[i + 1];
+		else if ("--filter" == option) filter = argv[i + 1];
+		else if ("--scale" == option) scale = std::stod(argv[i + 1]);
+		else if ("--soak" == option) soak = std::stoull(argv[i + 1]);
+	}
+
+	std::vector<v8easy::binding> bindings = {
+		// ߂l (Ăяô̂̏d)
+		{ "noop", [](argument&) {} },
+		{ "num", [](argument& args) {
+			args.result( args.get<double>(0) + 1 );
+		} },
+		{ "str", [](argument& args) {
+			args.result( args.get<std::string>(0) );
+		} },
+		{ "vec", [](argument& args) {
+			args.result( static_cast<double>(args.get<std::vector<double>>(0).size()) );
+		} },
+	};
+	v8easy js(argv[0], bindings);
+	js.set("typed", [](double x, double y) { return x + y; });
+	js.set<fast_add>("fast_add");
+	v8::Isolate* isolate = js;
+	bench_runner bench(filter, scale);
+
+	auto tmp = std::filesystem::temp_directory_path() / "v8easy_bench";
+	std::filesystem::create_directories(tmp);
+
+	// run() : Ⴄ\[X (RpC) Ɠ\[X̌JԂ
+	{
+		uint64_t serial = 0;
+		bench.measure(isolate, "run.cold", 2000, [&]() {
+			js.run("var x" + std::to_string(serial++) + " = 1; x0 + 1");
+		});
+		bench.measure(isolate, "run.repeat", 2000, [&]() {
+			js.run("1 + 1");
+		});
+		js.use_script_cache(64);
+		bench.measure(isolate, "run.repeat_script_cache", 2000, [&]() {
+			js.run("1 + 1");
+		});
+		js.use_script_cache(0);
+	}
+
+	// XibvVbg : Ăŏ run() I܂ (EH[AbṽXNvg𖈉ŝƁAs̏ԂN̂Ƃ̔r)
+	if (bench.enabled("startup.")) {
+		std::string warmup;
+		for (int i = 0; i < 2000; ++i)
+			warmup += "function lib" + std::to_string(i) + "(x) { return x * " + std::to_string(i) + " + 1; }\n";
+		warmup += "var table = {}; for (var i = 0; i < 10000; ++i) table['k' + i] = i;";
+		const std::string first = "lib1999(table.k9999)";
+		std::string error;
+		std::string blob = js.create_snapshot(error, { warmup });
+		bench.measure(isolate, "startup.cold_first_run", 20, [&]() {
+			v8easy fresh(argv[0], bindings);
+			fresh.run(warmup);
+			fresh.run(first);
+		});
+		if (blob.empty()) {
+			std::cerr << "startup.snapshot_first_run: " << error << std::endl;
+		} else {
+			auto result = bench.measure(isolate, "startup.snapshot_first_run", 20, [&]() {
+				v8easy fresh(argv[0], bindings, blob);
+				fresh.run(first);
+			});
+			if (result) result->extra = { { "snapshot_bytes", static_cast<double>(blob.size()) } };
+		}
+	}
+
+	// run_async() : v[̃XbhςāACPU gXNvg jobs đSI܂ (speedup 1XbhƂ̔)
+	if (bench.enabled("run_async.")) {
+		const uint64_t jobs = 64;
+		const std::string work = "var s = 0; for (var i = 0; i < 200000; ++i) s += i % 7; s";
+		size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+		double single = 0;
+		for (size_t threads = 1; threads <= hardware * 2; threads *= 2) {
+			js.use_pool(threads);
+			auto result = bench.measure(isolate, "run_async.threads" + std::to_string(threads), 3, [&]() {
+				std::vector<std::future<std::string>> futures;
+				for (uint64_t i = 0; i < jobs; ++i)
+					futures.push_back(js.run_async(work));
+				for (auto& future : futures)
+					future.get();
+			}, 0, jobs);
+			if (!result) continue;
+			if (1 == threads) single = result->ns_per_op;
+			result->extra = {
+				{ "threads", static_cast<double>(threads) },
+				{ "speedup", single > 0 ? single / result->ns_per_op : 0 },
+			};
+		}
+	}
+
+	// ֐̌Ăяo : js ̃[v̒ŌĂԂ̂1񂠂̓[v̉񐔂Ŋ
+	{
+		const uint64_t calls = 100000;
+		auto loop = [&calls](const std::string& call) {
+			return "for (var i = 0; i < " + std::to_string(calls) + "; ++i) " + call + ";";
+		};
+		bench.measure(isolate, "callback.empty_loop", 5, [&]() { js.run(loop("0")); }, 0, calls);
+		bench.measure(isolate, "callback.noop", 5, [&]() { js.run(loop("noop()")); }, 0, calls);
+		bench.measure(isolate, "callback.get_double_result", 5, [&]() { js.run(loop("num(i)")); }, 0, calls);
+		bench.measure(isolate, "callback.get_string_result", 5, [&]() { js.run(loop("str('hello')")); }, 0, calls);
+		auto typed = bench.measure(isolate, "callback.typed", 5, [&]() { js.run(loop("typed(i, 1)")); }, 0, calls);
+		double typed_ns = typed ? typed->ns_per_op : 0;
+		//  (double, double) ̊֐ set<֐>() œo^ (fast_api  0 Ȃ畁ʂ̌ĂяoƓ)
+		auto fast = bench.measure(isolate, "callback.fast_api", 5, [&]() { js.run(loop("fast_add(i, 1)")); }, 0, calls);
+		if (fast) fast->extra = {
+			{ "fast_api", static_cast<double>(V8EASY_FAST_API) },
+			{ "speedup_vs_typed", typed_ns > 0 ? typed_ns / fast->ns_per_op : 0 },
+		};
+		js.run("var bench_vec = []; for (var i = 0; i < 100; ++i) bench_vec.push(i);");
+		bench.measure(isolate, "callback.get_vector100", 5, [&]() { js.run(loop("vec(bench_vec)")); }, 0, calls / 10);
+	}
+
+	v8::HandleScope handle_scope(isolate);
+	auto context = js.useContext();
+	v8::Context::Scope context_scope(context);
+
+	// to_v8/from_v8 : ^
+	{
+		const uint64_t n = 200000;
+		double number = 12.5;
+		int integer = 42;
+		bool boolean = true;
+		int64_t bigint = 1234567890123ll;
+		std::string shortString = "hello v8easy", longString(1024, 'x');
+		std::vector<double> vector(1000, 1.5);
+		std::unordered_map<std::string, double> map;
+		for (int i = 0; i < 100; ++i) map["key" + std::to_string(i)] = i;
+
+		bench.measure(isolate, "to_v8.double", n, [&]() { v8easy::to_v8(isolate, number); });
+		bench.measure(isolate, "to_v8.int", n, [&]() { v8easy::to_v8(isolate, integer); });
+		bench.measure(isolate, "to_v8.bool", n, [&]() { v8easy::to_v8(isolate, boolean); });
+		bench.measure(isolate, "to_v8.int64", n, [&]() { v8easy::to_v8(isolate, bigint); });
+		bench.measure(isolate, "to_v8.string16", n, [&]() { v8easy::to_v8(isolate, shortString); }, shortString.size());
+		bench.measure(isolate, "to_v8.string1KB", n / 10, [&]() { v8easy::to_v8(isolate, longString); }, longString.size());
+		bench.measure(isolate, "to_v8.vector1000", n / 100, [&]() { v8easy::to_v8(isolate, vector); });
+		bench.measure(isolate, "to_v8.map100", n / 100, [&]() { v8easy::to_v8(isolate, map); });
+
+		auto v8_number = v8easy::to_v8(isolate, number);
+		auto v8_integer = v8easy::to_v8(isolate, integer);
+		auto v8_boolean = v8easy::to_v8(isolate, boolean);
+		auto v8_bigint = v8easy::to_v8(isolate, bigint);
+		auto v8_short = v8easy::to_v8(isolate, shortString);
+		auto v8_long = v8easy::to_v8(isolate, longString);
+		auto v8_vector = v8easy::to_v8(isolate, vector);
+		auto v8_map = v8easy::to_v8(isolate, map);
+		bench.measure(isolate, "from_v8.double", n, [&]() { v8easy::from_v8<double>(isolate, v8_number); });
+		bench.measure(isolate, "from_v8.int", n, [&]() { v8easy::from_v8<int, v8::Int32>(isolate, v8_integer); });
+		bench.measure(isolate, "from_v8.bool", n, [&]() { v8easy::from_v8<bool, v8::Boolean>(isolate, v8_boolean); });
+		bench.measure(isolate, "from_v8.int64", n, [&]() { v8easy::from_v8<int64_t>(isolate, v8_bigint); });
+		bench.measure(isolate, "from_v8.string16", n, [&]() { v8easy::from_v8<std::string>(isolate, v8_short); }, shortString.size());
+		bench.measure(isolate, "from_v8.string1KB", n / 10, [&]() { v8easy::from_v8<std::string>(isolate, v8_long); }, longString.size());
+		bench.measure(isolate, "from_v8.vector1000", n / 100, [&]() { v8easy::from_v8<std::vector<double>>(isolate, v8_vector); });
+		bench.measure(isolate, "from_v8.map100", n / 100, [&]() { v8easy::from_v8<std::unordered_map<std::string, double>>(isolate, v8_map); });
+	}
+
+	// vector ̕ϊ : to_v8/from_v8 ł܂Ƃ߂ĕϊ̂1vf Set/Get ̂̔r (1vf)
+	for (size_t size = 1000; size <= 10000000; size *= 10) {
+		std::vector<double> vector(size, 1.5), out;
+		auto length = static_cast<uint32_t>(size);
+		uint64_t n = std::max<uint64_t>(1, 1000000 / size);
+		std::string suffix = "_" + std::to_string(size);
+		bench.measure(isolate, "vector.to_v8" + suffix, n, [&]() {
+			v8::HandleScope scope(isolate);
+			v8easy::to_v8(isolate, vector);
+		}, size * sizeof(double), size);
+		bench.measure(isolate, "vector.set_each" + suffix, n, [&]() {
+			v8::HandleScope scope(isolate);
+			auto ary = v8::Array::New(isolate, static_cast<int>(size));
+			for (uint32_t i = 0; i < length; ++i)
+				ary->Set(context, i, v8::Number::New(isolate, vector[i])).FromJust();
+		}, size * sizeof(double), size);
+
+		auto v8_vector = v8easy::to_v8(isolate, vector).As<v8::Array>();
+		bench.measure(isolate, "vector.from_v8" + suffix, n, [&]() {
+			out = v8easy::from_v8<std::vector<double>>(isolate, v8_vector);
+		}, size * sizeof(double), size);
+		bench.measure(isolate, "vector.get_each" + suffix, n, [&]() {
+			v8::HandleScope scope(isolate);
+			out.resize(size);
+			for (uint32_t i = 0; i < length; ++i)
+				out[i] = v8_vector->Get(context, i).ToLocalChecked()->NumberValue(context).FromJust();
+		}, size * sizeof(double), size);
+	}
+
+	// array  for  : z index ŁAIuWFNg̓L[̈ꗗĂ
+	{
+		v8easy::array ary(evaluate(isolate, "Array.from({ length: 10000 }, (_, i) => i)"));
+		v8easy::array obj(evaluate(isolate, "var o = {}; for (var i = 0; i < 1000; ++i) o['k' + i] = i; o"));
+		double sum = 0;
+		bench.measure(isolate, "array.iterate_array10000", 20, [&]() {
+			for (auto&& e : ary) sum += e.get<double>();
+		}, 0, 10000);
+		bench.measure(isolate, "array.iterate_object1000", 200, [&]() {
+			for (auto&& e : obj) sum += e.get<double>();
+		}, 0, 1000);
+		bench.measure(isolate, "array.items_object1000", 200, [&]() {
+			for (auto&& item : obj.items<std::string, double>()) sum += item.second;
+		}, 0, 1000);
+
+		// L[̈ꗗ begin() 1񂾂̂ŁAL[10{ɂȂĂ1L[̎Ԃ͕ςȂ͂ (per_key_ratio  1 ɋ߂)
+		double per_key_10k = 0;
+		for (int keys : { 10000, 100000 }) {
+			v8easy::array large(evaluate(isolate, "var o = {}; for (var i = 0; i < " + std::to_string(keys) + "; ++i) o['k' + i] = i; o"));
+			auto result = bench.measure(isolate, "array.iterate_object" + std::to_string(keys), 2000000 / keys, [&]() {
+				for (auto&& e : large) sum += e.get<double>();
+			}, 0, keys);
+			if (!result) continue;
+			if (10000 == keys) per_key_10k = result->ns_per_op;
+			else result->extra = { { "per_key_ratio", per_key_10k > 0 ? result->ns_per_op / per_key_10k : 0 } };
+		}
+		if (sum < 0) std::cerr << sum;
+	}
+
+	// read() : ASCII ̓}bv܂܁AȊO UTF-16 ɂĂn
+	for (size_t bytes : { size_t(1024), size_t(100 * 1024), size_t(10 * 1024 * 1024) }) {
+		auto ascii = tmp / ("ascii_" + size_name(bytes) + ".js");
+		auto utf8 = tmp / ("utf8_" + size_name(bytes) + ".js");
+		std::string text;
+		while (text.size() < bytes) text += "var a = 'abcdefghijklmnopqrstuvwxyz';\n";
+		write_file(ascii, text);
+		text.clear();
+		while (text.size() < bytes) text += "var a = '\xe3\x81\x82\xe3\x81\x84\xe3\x81\x86\xe3\x81\x88\xe3\x81\x8a\xe3\x81\x8b\xe3\x81\x8d\xe3\x81\x8f\xe3\x81\x91\xe3\x81\x93';\n";
+		write_file(utf8, text);
+
+		uint64_t n = std::max<uint64_t>(5, 50 * 1024 * 1024 / bytes / 10);
+		bench.measure(isolate, "read.ascii_" + size_name(bytes), n, [&]() { js.read(ascii.string()); }, bytes);
+		bench.measure(isolate, "read.utf8_" + size_name(bytes), n, [&]() { js.read(utf8.string()); }, bytes);
+	}
+
+	// variant/JSON : 1KB/100KB/10MB  JSON 1ϊ鑬
+	for (size_t bytes : { size_t(1024), size_t(100 * 1024), size_t(10 * 1024 * 1024) }) {
+		std::string json = make_json(bytes), printBuffer;
+		uint64_t n = std::max<uint64_t>(3, 20 * 1024 * 1024 / json.size() / 10);
+		bench.measure(isolate, "json.parse_" + size_name(bytes), n, [&]() {
+			js.json_parse(std::string_view(json), printBuffer);
+		}, json.size());
+
+		v8::Local<v8::Value> value;
+		if (!js.json_parse(std::string_view(json), printBuffer).ToLocal(&value)) continue;
+		std::string stringified;
+		bench.measure(isolate, "json.stringify_" + size_name(bytes), n, [&]() {
+			stringified = js.json_stringify(value, printBuffer);
+		}, json.size());
+		v8easy::document document;
+		bench.measure(isolate, "variant.to_variant_" + size_name(bytes), n, [&]() {
+			v8easy::to_variant(isolate, value, document, printBuffer);
+		}, json.size());
+		bench.measure(isolate, "variant.to_v8_" + size_name(bytes), n, [&]() {
+			v8easy::to_v8(isolate, document.root);
+		}, json.size());
+
+		// lʂ̂Ƃ֎ʂ̉ : JSON oR̂ variant oR̂̔r
+		bench.measure(isolate, "json.round_trip_" + size_name(bytes), n, [&]() {
+			std::string text = js.json_stringify(value, printBuffer);
+			js.json_parse(std::string_view(text), printBuffer);
+		}, json.size());
+		bench.measure(isolate, "variant.round_trip_" + size_name(bytes), n, [&]() {
+			v8easy::document copy;
+			v8easy::to_variant(isolate, value, copy, printBuffer);
+			v8easy::to_v8(isolate, copy.root);
+		}, json.size());
+	}
+
+	// ReLXgv[ : run_isolated() 1̎ (؂EsEԂE[܂őS) v[Ɣׂ
+	if (bench.enabled("context_pool.")) {
+		bench.measure(isolate, "context_pool.run_isolated_no_pool", 200, [&]() { js.run_isolated("1 + 1"); });
+		js.use_context_pool(8);
+		auto result = bench.measure(isolate, "context_pool.run_isolated_pool8", 200, [&]() { js.run_isolated("1 + 1"); });
+		auto stats = js.context_pool();
+		if (result) result->extra = {
+			{ "hit", static_cast<double>(stats.hit) }, { "miss", static_cast<double>(stats.miss) },
+			{ "replenished", static_cast<double>(stats.replenished) },
+			{ "checkout_p50_us", stats.p50 }, { "checkout_p99_us", stats.p99 },
+			{ "request_p50_us", stats.request_p50 }, { "request_p90_us", stats.request_p90 }, { "request_p99_us", stats.request_p99 },
+		};
+		js.use_context_pool(0);
+	}
+
+	// Xg[~O : 傫t@C stream() œǂ݂Ȃ\͂̂ run() őSǂł̔r
+	{
+		auto large = tmp / "stream_large.js";
+		std::string text;
+		for (int i = 0; text.size() < 8 * 1024 * 1024; ++i)
+			text += "function f" + std::to_string(i) + "(a, b) { var c = a * b + " + std::to_string(i) + "; return c > 10 ? c - 1 : c + 1; }\n";
+		text += "'done'";
+		write_file(large, text);
+		bench.measure(isolate, "stream.run_file_8MB", 3, [&]() { js.run("", large.string()); }, text.size());
+		bench.measure(isolate, "stream.stream_run_8MB", 3, [&]() {
+			auto script = js.stream(large.string());
+			js.run(script);
+		}, text.size());
+	}
+
+	// ̃oh : ŏ1s܂ł̎ (S stream() Ă1ڂ҂̂ƁA1 run() ̂̔r)
+	{
+		const int count = 8;
+		std::vector<std::string> bundles;
+		size_t total = 0;
+		for (int b = 0; b < count; ++b) {
+			auto path = tmp / ("bundle" + std::to_string(b) + ".js");
+			std::string text;
+			for (int i = 0; text.size() < 1024 * 1024; ++i)
+				text += "function b" + std::to_string(b) + "_" + std::to_string(i) + "(a) { return a > 10 ? a - " + std::to_string(i) + " : a + 1; }\n";
+			text += "'bundle" + std::to_string(b) + "'";
+			write_file(path, text);
+			bundles.push_back(path.string());
+			total += text.size();
+		}
+		// stream() c̓[J[XbhőĂ̂ŁA1ڂIŎv~߂ (c҂͓Ȃ)
+		if (bench.enabled("stream.bundles8_first")) {
+			std::vector<double> sequential, streamed;
+			for (int round = 0; round < 5; ++round) {
+				auto start = clock_type::now();
+				js.run("", bundles[0]);
+				sequential.push_back(std::chrono::duration<double, std::milli>(clock_type::now() - start).count());
+				for (size_t b = 1; b < bundles.size(); ++b)
+					js.run("", bundles[b]);
+
+				start = clock_type::now();
+				std::vector<v8easy::streaming_script> scripts;
+				for (auto& bundle : bundles)
+					scripts.push_back(js.stream(bundle));
+				js.run(scripts[0]);
+				streamed.push_back(std::chrono::duration<double, std::milli>(clock_type::now() - start).count());
+				for (size_t b = 1; b < scripts.size(); ++b)
+					js.run(scripts[b]);
+			}
+			std::sort(sequential.begin(), sequential.end());
+			std::sort(streamed.begin(), streamed.end());
+			bench.record("stream.bundles8_first_execution", {
+				{ "run_p50_ms", sequential[sequential.size() / 2] },
+				{ "stream_all_p50_ms", streamed[streamed.size() / 2] },
+			});
+		}
+		bench.measure(isolate, "stream.bundles8_run_all", 3, [&]() {
+			for (auto& bundle : bundles)
+				js.run("", bundle);
+		}, total);
+		bench.measure(isolate, "stream.bundles8_stream_all_run_all", 3, [&]() {
+			std::vector<v8easy::streaming_script> scripts;
+			for (auto& bundle : bundles)
+				scripts.push_back(js.stream(bundle));
+			for (auto& script : scripts)
+				js.run(script);
+		}, total);
+	}
+
+	// I : ɈĂ~܂܂ł̎
+	if (bench.enabled("terminate")) {
+		v8easy::budget limits;
+		limits.wall = std::chrono::milliseconds(10);
+		std::vector<double> latency;
+		for (int i = 0; i < 20; ++i) {
+			auto result = js.run("for (;;) {}", "terminate.js", limits);
+			latency.push_back(static_cast<double>(result.terminate_latency.count()));
+		}
+		std::sort(latency.begin(), latency.end());
+		bench.record("terminate.wall_10ms", {
+			{ "p50_us", latency[latency.size() / 2] }, { "max_us", latency.back() },
+		});
+	}
+
+	//  :  isolate ŉ run() ăq[vƏ풓Ȃ
+	// ŏ 1/10  JIT LbV܂łƂāAŌ܂ł̑𒴂玸sɂ
+	bool soakFailed = false;
+	if (bench.enabled("soak")) {
+		const size_t heapLimit = 4 * 1024 * 1024, rssLimit = 32 * 1024 * 1024;
+		uint64_t warmup = std::max<uint64_t>(1, soak / 10);
+		js.run("var soak = 0;");
+		for (uint64_t i = 0; i < warmup; ++i)
+			js.run("soak += 1; ({ a: [soak, 'x' + soak] }).a.length");
+		isolate->LowMemoryNotification();
+		auto heapStart = heap_used(isolate), rssStart = resident_bytes();
+		auto start = clock_type::now();
+		for (uint64_t i = warmup; i < soak; ++i)
+			js.run("soak += 1; ({ a: [soak, 'x' + soak] }).a.length");
+		std::chrono::duration<double> elapsed = clock_type::now() - start;
+		isolate->LowMemoryNotification();
+		auto heapEnd = heap_used(isolate), rssEnd = resident_bytes();
+		soakFailed = heapEnd > heapStart + heapLimit || rssEnd > rssStart + rssLimit;
+		if (soakFailed)
+			std::cerr << "soak.run: memory grew (heap " << heapStart << " -> " << heapEnd << ", rss " << rssStart << " -> " << rssEnd << ")" << std::endl;
+		bench.record("soak.run", {
+			{ "runs", static_cast<double>(soak) }, { "seconds", elapsed.count() },
+			{ "heap_start", static_cast<double>(heapStart) }, { "heap_end", static_cast<double>(heapEnd) },
+			{ "rss_start", static_cast<double>(rssStart) }, { "rss_end", static_cast<double>(rssEnd) },
+			{ "flat", soakFailed ? 0.0 : 1.0 },
+		});
+	}
+
+	std::filesystem::remove_all(tmp);
+
+	auto json = bench.json();
+	if (outFile.empty())
+		std::cout << json;
+	else
+		std::ofstream(outFile, std::ios::out | std::ios::binary | std::ios::trunc) << json;
+	return soakFailed ? 1 : 0;
+}
@@ -1,6 +1,11 @@
 
 #include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include <future>
 #include <iostream>
+#include <stdexcept>
 #include <thread>
 
 #include "v8easy.h"
@@ -33,61 +38,197 @@ bool enumNest(v8easy::array ary, int indent) {
 	return true;
 }
 
+// Fast API ŌĂׂ`̊֐ (Ɩ߂ll)
+double fast_mul(double a, double b) {
+	return a * b;
+}
+
+// W͂1s file ̊֐ɒʂĕWo͂ɏ (jobs  2 ȏȂXbhɕĂԂ͂̂܂)
+int map_stdin(v8easy& js, const std::string& file, bool ndjson, size_t jobs) {
+	const size_t chunk_size = 1 << 20;
+	std::vector<char> input(chunk_size);
+	// stdout ͂̌ĝŃobt@ static ɂĂ
+	static std::vector<char> output(chunk_size);
+	std::setvbuf(stdout, output.data(), _IOFBF, output.size());
+
+	std::string pending, result, error;
+	std::deque<std::future<std::string>> running;
+	auto write = [](const std::string& text) { std::fwrite(text.data(), 1, text.size(), stdout); };
+	auto process = [&](std::string chunk) {
+		if (jobs <= 1) {
+			result.clear();
+			if (!js.map_lines(file, ndjson, chunk, result, error))
+				throw std::runtime_error(error);
+			write(result);
+			return;
+		}
+		running.push_back(js.async_pool().submit([file, ndjson, chunk = std::move(chunk)](v8easy& worker) {
+			std::string text, message;
+			if (!worker.map_lines(file, ndjson, chunk, text, message))
+				throw std::runtime_error(message);
+			return text;
+		}));
+		// 擪珇ɏ̂ŁA܂肷Â҂
+		while (jobs * 2 <= running.size()) {
+			write(running.front().get());
+			running.pop_front();
+		}
+	};
+
+	try {
+		size_t length;
+		while (0 < (length = std::fread(input.data(), 1, input.size(), stdin))) {
+			pending.append(input.data(), length);
+			auto last = pending.rfind('\n');
+			if (std::string::npos == last) continue;
+			process(pending.substr(0, last));
+			pending.erase(0, last + 1);
+		}
+		if (!pending.empty())
+			process(pending);
+		for (; !running.empty(); running.pop_front())
+			write(running.front().get());
+	} catch (const std::exception& e) {
+		std::fflush(stdout);
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+	std::fflush(stdout);
+	return 0;
+}
+
 enum BOOT_OPTION {
 	BO_INTERACTIVE = 0,
 	BO_ONELINE,
 	BO_FILE,
+	BO_CODE_CACHE,
+	BO_SNAPSHOT,
+	BO_TIMEOUT,
+	BO_MAP,
+	BO_MODULE,
+	BO_JOBS,
 	BO_USAGE,
 };
 int main(int argc, char* argv[]) {
-	v8easy js(argv[0]);
-	// case o
-	js.set("version", v8_version);
-	// case std::string
-	js.set("print", [](argument& args) {
-		std::cout << args.get<std::string>(0) << std::endl;
-	});
-	// case double
-	js.set("mul", [](argument& args) {
-		args.result( args.get<double>(0) * args.get<double>(1) );
-	});
-	// case long long
-	js.set("add_long", [](argument& args) {
-		args.result( args.get<int64_t>(0) + args.get<int64_t>(1) );
-	});
-	// case int
-	js.set("plus", [](argument& args) {
-		v8easy::value v1 = 123, v2 = 456;
-		args.result( v1.get<int>() + v2.get<int>() + args.get<int>(0) + args.get<int>(1) );
-	});
-	// case bool
-	js.set("not", [](argument& args) {
-		args.result( !args.get<bool>(0) );
-	});
-	// case JavaScript ̊֐ C++ ŌĂ
-	js.set("func", [](argument& args) {
-		v8easy::value funcArg[2] = { 45.6, 789 };
-		auto func = args.get<v8easy::function>(0);
-		args.result(func.call<std::string>(2, funcArg));
-	});
-	// case JavaScript {z/IuWFNg} C++ ŎQƂ
-	js.set("print_r", [](argument& args) {
-		if (args.get(1)->IsArray()) {
-			for (auto&& ary_prm : args.get(0)) {
-				// ary_prm ̌^͂肵ȂƗO
-				// 悪 Object ɑƂ͔z̃L[w肵ȂƗO
-				// IsHoge Ō^肵 set ł邯ǂ߂ǂƂ肠 std::string łԂ
-				args.get(1).set(ary_prm.index, ary_prm.get<std::string>());
+	// o^֐ (--snapshot ŋN鎞͍ƓтœnKv̂ŐɑSׂƂ)
+	std::vector<v8easy::binding> bindings = {
+		// case o
+		{ "version", v8_version },
+		// case std::string
+		{ "print", [](argument& args) {
+			std::cout << args.get<std::string>(0) << std::endl;
+		} },
+		// case double
+		{ "mul", [](argument& args) {
+			args.result( args.get<double>(0) * args.get<double>(1) );
+		} },
+		// case long long
+		{ "add_long", [](argument& args) {
+			args.result( args.get<int64_t>(0) + args.get<int64_t>(1) );
+		} },
+		// case int
+		{ "plus", [](argument& args) {
+			v8easy::value v1 = 123, v2 = 456;
+			args.result( v1.get<int>() + v2.get<int>() + args.get<int>(0) + args.get<int>(1) );
+		} },
+		// case bool
+		{ "not", [](argument& args) {
+			args.result( !args.get<bool>(0) );
+		} },
+		// case JavaScript ̊֐ C++ ŌĂ
+		{ "func", [](argument& args) {
+			v8easy::value funcArg[2] = { 45.6, 789 };
+			auto func = args.get<v8easy::function>(0);
+			args.result(func.call<std::string>(2, funcArg));
+		} },
+		// case JavaScript  Float64Array Rs[ C++ œǂ
+		{ "sum", [](argument& args) {
+			double sum = 0;
+			for (auto value : args.get<v8easy::float64_array>(0).data())
+				sum += value;
+			args.result(sum);
+		} },
+		// case JavaScript ̔z std::vector ł܂Ƃ߂ĂĕԂ
+		{ "reverse", [](argument& args) {
+			auto values = args.get<std::vector<double>>(0);
+			args.result(std::vector<double>(values.rbegin(), values.rend()));
+		} },
+		// case JavaScript {z/IuWFNg} C++ ŎQƂ
+		{ "print_r", [](argument& args) {
+			if (args.get(1)->IsArray()) {
+				for (auto&& ary_prm : args.get(0)) {
+					// ary_prm ̌^͂肵ȂƗO
+					// 悪 Object ɑƂ͔z̃L[w肵ȂƗO
+					// IsHoge Ō^肵 set ł邯ǂ߂ǂƂ肠 std::string łԂ
+					args.get(1).set(ary_prm.index, ary_prm.get<std::string>());
+				}
+				return;
 			}
-			return;
+
+			enumNest(args.get(0), 1);
+		} }
+	};
+
+	// --snapshot {file} ̃t@C΂N (΋Nɍ)
+	std::string snapshot;
+	for (int i = 1; i + 1 < argc; ++i) {
+		if (std::string("--snapshot") != argv[i]) continue;
+		std::ifstream ifs(argv[i + 1], std::ios::in | std::ios::binary);
+		if (!ifs.fail())
+			snapshot.assign((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+	}
+	// --stats w肳ꂽIɌvl\
+	v8easy::options settings;
+	for (int i = 1; i < argc; ++i)
+		settings.metrics |= std::string("--stats") == argv[i];
+	v8easy js(argv[0], bindings, snapshot, settings);
+	// --prof={file} / --heap-prof={file} w肳ꂽŏāAIɏo
+	std::string cpuProfile, heapProfile;
+	for (int i = 1; i < argc; ++i) {
+		std::string param = argv[i];
+		if (0 == param.rfind("--prof=", 0))
+			cpuProfile = param.substr(7);
+		else if (0 == param.rfind("--heap-prof=", 0))
+			heapProfile = param.substr(12);
+	}
+	if (!cpuProfile.empty() || !heapProfile.empty())
+		js.start_profiling(!cpuProfile.empty(), !heapProfile.empty());
+
+	auto report = [&]() {
+		if (!cpuProfile.empty() || !heapProfile.empty()) {
+			auto profile = js.stop_profiling();
+			if (!cpuProfile.empty())
+				std::ofstream(cpuProfile, std::ios::out | std::ios::binary | std::ios::trunc) << profile.cpu;
+			if (!heapProfile.empty())
+				std::ofstream(heapProfile, std::ios::out | std::ios::binary | std::ios::trunc) << profile.heap;
 		}
+		if (settings.metrics)
+			std::cout << js.metrics().text();
+	};
+	// case Ɩ߂ľ^ϊ߂ēo^
+	js.set("hypot", [](double x, double y) { return std::sqrt(x * x + y * y); });
+	// case œKꂽ js 璼ڌĂ΂֐o^
+	js.set<fast_mul>("fast_mul");
+	// case Ԃ֐ (Lv`t_) o^
+	int counter = 0;
+	js.set("count", [&counter]() { return ++counter; });
 
-		enumNest(args.get(0), 1);
-	});
+	// --timeout {~b} w肳ꂽ炻̎ԂŎ~߂ (--oneline/--include/--module ɌA--map 1sȂ̂ŌȂ)
+	v8easy::budget limits;
+	auto print_result = [](const v8easy::run_result& result) {
+		if (v8easy::run_result::error::wall_time == result.reason)
+			return "timeout (" + std::to_string(result.elapsed.count() / 1000) + "ms)";
+		return result.ok() ? result.value : result.message;
+	};
+	auto run_source = [&js, &limits, &print_result](const std::string& source) {
+		if (!limits.wall.count())
+			return js.run(source);
+		return print_result(js.run(source, "", limits));
+	};
 
-	auto js_run = [&js](std::string& source) {
+	auto js_run = [&run_source](std::string& source) {
 		if (source.empty()) return true;
-		std::cout << "result:" << std::endl << js.run(source) << std::endl << ">";
+		std::cout << "result:" << std::endl << run_source(source) << std::endl << ">";
 
 		std::cin.clear();
 		source.clear();
@@ -95,6 +236,23 @@ int main(int argc, char* argv[]) {
 	};
 
 	std::string source, file, line;
+	std::vector<v8easy::streaming_script> includes;
+	// ߂Ă --include ꂽɎs (--module/--map/XNvg)
+	auto run_includes = [&js, &includes, &limits, &print_result]() {
+		for (auto& script : includes)
+			std::cout << (limits.wall.count() ? print_result(js.run(script, limits)) : js.run(script)) << std::endl;
+		includes.clear();
+	};
+	// --include ŊJȂt@Cm点
+	auto unopened_include = [&file]() {
+		if (!file.empty())
+			std::cout << "can not open include file: " << file << std::endl;
+		file.clear();
+	};
+	// --map {script} [--ndjson] [--jobs {N}]
+	std::string mapFile;
+	bool ndjson = false;
+	size_t jobs = 1;
 	BOOT_OPTION bo = BO_INTERACTIVE;
 	if (1 < argc) {
 		++argv;
@@ -103,20 +261,37 @@ int main(int argc, char* argv[]) {
 			{ "--interactive", BO_INTERACTIVE },
 			{ "--oneline" , BO_ONELINE },
 			{ "--include", BO_FILE },
+			{ "--code-cache", BO_CODE_CACHE },
+			{ "--snapshot", BO_SNAPSHOT },
+			{ "--timeout", BO_TIMEOUT },
+			{ "--map", BO_MAP },
+			{ "--module", BO_MODULE },
+			{ "--ndjson", BO_INTERACTIVE },
+			{ "--jobs", BO_JOBS },
+			{ "--stats", BO_INTERACTIVE },
+			{ "--prof={file}", BO_INTERACTIVE },
+			{ "--heap-prof={file}", BO_INTERACTIVE },
 			{ "--usage", BO_USAGE },
 			{ "--help", BO_USAGE }
 		};
 
 		for (auto& param : args) {
+			// N鎞ɌĂ̂œǂݔ΂
+			if ("--stats" == param || 0 == param.rfind("--prof=", 0) || 0 == param.rfind("--heap-prof=", 0)) continue;
+			if ("--ndjson" == param) {
+				ndjson = true;
+				continue;
+			}
 			try {
 				bo = options.at(param.data());
+				unopened_include();
 				if (BO_USAGE == bo) {
 					std::cout << "v8 ver." << js.run("version();") << " usage list" << std::endl;
 					for (auto& option : options)
 						std::cout << option.first << std::endl;
 				}
 				continue;
-			} catch (std::out_of_range) {
+			} catch (const std::out_of_range&) {
 			}
 
 			switch (bo) {
@@ -124,21 +299,83 @@ int main(int argc, char* argv[]) {
 			case BO_ONELINE:
 				source += param + " ";
 				break;
-			case BO_FILE:
-				file += param + " ";
-				std::ifstream ifs(file);
-				if (!ifs.fail()) {
-					std::cout << js.run("", file) << std::endl;
-					file = "";
+			case BO_FILE: {
+				// 󔒂܂ރpX͈ė̂ŁAÖŊJȂ͂ȂĊJĂ݂
+				// ǂݍ݂ƃRpC͗Ŏn߂ĂāASĂ珇Ɏs
+				std::string joined = file.empty() ? param : file + " " + param;
+				if (!std::ifstream(joined).fail()) {
+					includes.push_back(js.stream(joined));
+					file.clear();
+				} else if (!file.empty() && !std::ifstream(param).fail()) {
+					unopened_include();
+					includes.push_back(js.stream(param));
+				} else {
+					file = joined;
+				}
+				break;
+			}
+			case BO_CODE_CACHE:
+				// --code-cache {directory} ͕̌ʂɑΘb[h֖߂
+				js.use_code_cache(param);
+				bo = BO_INTERACTIVE;
+				break;
+			case BO_SNAPSHOT:
+				// Nɓǂ߂Ȃo^Ă֐ŃXibvVbg
+				if (snapshot.empty()) {
+					std::string error;
+					snapshot = js.create_snapshot(error);
+					if (snapshot.empty()) {
+						std::cout << error << std::endl;
+					} else {
+						std::ofstream ofs(param, std::ios::out | std::ios::binary | std::ios::trunc);
+						ofs.write(snapshot.data(), snapshot.size());
+					}
 				}
+				bo = BO_INTERACTIVE;
+				break;
+			case BO_TIMEOUT:
+				limits.wall = std::chrono::milliseconds(std::stoll(param));
+				bo = BO_INTERACTIVE;
+				break;
+			case BO_MODULE: {
+				// ES module ƂĎs (import t@Cǂ)
+				run_includes();
+				auto result = limits.wall.count() ? js.run_module(param, limits) : js.run_module(param);
+				std::cout << print_result(result) << std::endl;
+				break;
+			}
+			case BO_MAP:
+				mapFile = param;
+				bo = BO_INTERACTIVE;
+				break;
+			case BO_JOBS:
+				jobs = std::stoul(param);
+				bo = BO_INTERACTIVE;
+				break;
+			case BO_USAGE:
 				break;
 			}
 		}
 
+		unopened_include();
+		run_includes();
+		if (!mapFile.empty()) {
+			if (1 < jobs)
+				js.use_pool(jobs);
+			int code = map_stdin(js, mapFile, ndjson, jobs);
+			report();
+			return code;
+		}
 		if (!source.empty())
-			std::cout << js.run(source, "");
-		if (bo != BO_INTERACTIVE)
+			std::cout << run_source(source);
+		if (bo != BO_INTERACTIVE) {
+			// setTimeout() ȂǂŎcĂ̂SI点Ă甲
+			std::string error;
+			if (!js.run_loop(error))
+				std::cout << error << std::endl;
+			report();
 			return 0;
+		}
 	}
 
 	std::cout << "welcome v8 shell ver." << js.run("version();") << std::endl << ">";
@@ -149,6 +386,7 @@ int main(int argc, char* argv[]) {
 			if (js_run(source)) break;
 	};
 
+	report();
 	std::cout << "exit." << std::endl;
 	std::this_thread::sleep_for( std::chrono::milliseconds(200) );
 	
@@ -1,15 +1,56 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <deque>
 #include <filesystem>
 #include <fstream>
 #include <functional>
+#include <future>
+#include <limits>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 #include <libplatform/libplatform.h>
 #include <v8.h>
+#include <v8-profiler.h>
+
+// Fast API (v8::CFunction) g V8 ǂ (NuGet  7.5 ɂ͖ANode.js ̓wb_[ɂ)
+#if 10 <= V8_MAJOR_VERSION && __has_include(<v8-fast-api-calls.h>)
+	#include <v8-fast-api-calls.h>
+	#define V8EASY_FAST_API 1
+#else
+	#define V8EASY_FAST_API 0
+#endif
 
 #ifdef _WIN32
 	// Windows
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#include <windows.h>
 	#pragma comment(lib, "v8.dll.lib")
 	#pragma comment(lib, "v8_libbase.dll.lib")
 	#pragma comment(lib, "v8_libplatform.dll.lib")
@@ -20,6 +61,10 @@
 	#endif
 #else
 	// Linux
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
 	#ifdef __x86_64__
 		// 64bit
 	#else
@@ -49,8 +94,27 @@ public:
 	// to
 	// <Source=double>  <Dest=v8::Integer> ɂ v8::Local œ
 	template<class Source = double, class Dest = v8::Number>
-	static v8::Local<v8::Value> to_v8(v8::Isolate* isolate, const Source& value, int length = -1) {
-		return Dest::New(isolate, *const_cast<Source*>(&value) ).As<v8::Value>();
+	static v8::Local<v8::Value> to_v8(v8::Isolate* isolate, const Source& value, int = -1) {
+		if constexpr (std::is_convertible_v<Source, v8::Local<v8::Value>>) {
+			// array/typed_array ݂ɍŏ v8::Local Ȃ̂͂̂܂
+			return value;
+		} else if constexpr (std::is_same_v<Source, v8::FunctionCallback>) {
+			// {lambda}void(*)(const v8::FunctionCallBackInfo&)  v8::Local œ
+			auto func = v8::FunctionTemplate::New(isolate, value);
+			return *reinterpret_cast<v8::Local<v8::Value>*>(const_cast<v8::Local<v8::FunctionTemplate>*>(&func));
+		} else if constexpr (std::is_same_v<Source, callback>) {
+			// {lambda}void(*)(v8easy::argument&)  v8::FunctionCallback ɂĂ v8::Local œ
+			return to_v8(isolate, (v8::FunctionCallback)value);
+		} else if constexpr (std::is_same_v<Source, bool> && std::is_same_v<Dest, v8::Number>) {
+			// bool  v8::Boolean ɂ v8::Local œ
+			// (to_v8<bool, v8::Boolean> Ə GCC  std::vector<bool, v8::Boolean> ̕܂ŎĎʂ̂Œڍ)
+			return cast( v8::Boolean::New(isolate, value) );
+		} else if constexpr (std::is_same_v<Source, int64_t> && std::is_same_v<Dest, v8::Number>) {
+			// long long  v8::BigInt ɂ v8::Local œ
+			return cast( v8::BigInt::New(isolate, value) );
+		} else {
+			return Dest::New(isolate, *const_cast<Source*>(&value) ).template As<v8::Value>();
+		}
 	}
 	// std::string  v8::String ɂ v8::Local œ
 	static v8::Local<v8::Value> to_v8(v8::Isolate* isolate, const std::string& value, int length = -1) {
@@ -60,63 +124,229 @@ public:
 	static v8::Local<v8::Value> to_v8(v8::Isolate* isolate, const char* value, int length = -1) {
 		return cast( v8::String::NewFromUtf8(isolate, value, v8::NewStringType::kNormal, length).ToLocalChecked() );
 	}
-	// {lambda}void(*)(const v8::FunctionCallBackInfo&)  v8::Local œ
-	template<>
-	static v8::Local<v8::Value> to_v8(v8::Isolate* isolate, const v8::FunctionCallback& value, int length) {
-		auto func = v8::FunctionTemplate::New(isolate, value);
-		return *reinterpret_cast<v8::Local<v8::Value>*>(const_cast<v8::Local<v8::FunctionTemplate>*>(&func));
+	// std::vector<T>  v8::Array ɂ v8::Local œ (q)
+	template<class T, class Allocator>
+	static v8::Local<v8::Value> to_v8(v8::Isolate* isolate, const std::vector<T, Allocator>& value) {
+		return to_v8_array(isolate, value);
 	}
-	// {lambda}void(*)(v8easy::argument&)  v8::FunctionCallback ɂĂ v8::Local œ
-	template<>
-	static inline v8::Local<v8::Value> to_v8<callback>(v8::Isolate* isolate, const callback& value, int length) {
-		return to_v8(isolate, (v8::FunctionCallback)value);
+	// std::array<T, N>  v8::Array ɂ v8::Local œ (q)
+	template<class T, size_t N>
+	static v8::Local<v8::Value> to_v8(v8::Isolate* isolate, const std::array<T, N>& value) {
+		return to_v8_array(isolate, value);
 	}
-	// bool  v8::Boolean ɂ v8::Local œ
-	template<>
-	static inline v8::Local<v8::Value> to_v8<bool>(v8::Isolate* isolate, const bool& value, int length) {
-		return to_v8<bool, v8::Boolean>(isolate, value);
+	// std::unordered_map<std::string, T>  v8::Object ɂ v8::Local œ (q)
+	template<class T>
+	static v8::Local<v8::Value> to_v8(v8::Isolate* isolate, const std::unordered_map<std::string, T>& value) {
+		auto context = isolate->GetCurrentContext();
+		auto object = v8::Object::New(isolate);
+		for (auto& pair : value) {
+			object->CreateDataProperty(
+				context,
+				as<v8::String>(to_v8(isolate, pair.first)),
+				to_v8(isolate, pair.second)
+			).FromJust();
+		}
+		return object;
 	}
-	// long long  v8::BigInt ɂ v8::Local œ
-	template<>
-	static inline v8::Local<v8::Value> to_v8<int64_t>(v8::Isolate* isolate, const int64_t& value, int length) {
-		return to_v8<int64_t, v8::BigInt>(isolate, value);
+	// vfɑSĂ v8::Array::New 1ō (1 Set 葬)
+	template<class Container>
+	static v8::Local<v8::Value> to_v8_array(v8::Isolate* isolate, const Container& value) {
+		std::vector<v8::Local<v8::Value>> elements;
+		elements.reserve(value.size());
+		for (auto it = value.begin(); it != value.end(); ++it) {
+			// std::vector<bool> ͗vf bool Ȃ̂ňU value_type ɂĂϊ
+			const typename Container::value_type& element = *it;
+			elements.push_back(to_v8(isolate, element));
+		}
+		return v8::Array::New(isolate, elements.data(), elements.size());
 	}
 
 	// from
-	// v8::Local<v8::Hoge>  <Dest=double> ɂ
-	template<class Dest = double, class Source = v8::Number>
-	static const Dest from_v8(v8::Isolate* dummy, v8::Local<v8::Value> value) {
-		return static_cast<Dest>( v8::Local<Source>::Cast( value )->Value() );
-	}
-	// v8::Local<v8::Hoge>  <Dest=double> ɂ
 	class object : public v8::Object {
 	public:
 		object(const v8::Object& parent) : v8::Object(parent) {}
 		void* get() { return this->GetAlignedPointerFromInternalField(0); }
 	};
-	// v8::Local<v8::FunctionTemplate> 𖳗 v8easy::callback ɂ
-	template<>
-	static const callback from_v8<v8easy::callback, v8::Number>(v8::Isolate* isolate, v8::Local<v8::Value> value) {
-//		auto ft = v8::Local<v8::FunctionTemplate>::Cast(value);
-		auto ft = *reinterpret_cast<v8::Local<v8::FunctionTemplate>*>(const_cast<v8::Local<v8::Value>*>(&value));
-		auto f = ft->GetFunction( v8::Isolate::GetCurrent()->GetCurrentContext() ).ToLocalChecked();
-		auto o = (*f)->ToObject( v8::Isolate::GetCurrent() );
-		object obj(**o);
-		return (callback)obj.get();
-	}
-	// v8::Local<v8::BigInt>  int64_t ɂ
-	template<>
-	static const int64_t from_v8(v8::Isolate* isolate, v8::Local<v8::Value> value) {
-		return static_cast<int64_t>( v8::Local<v8::BigInt>::Cast(value)->IntegerValue(isolate->GetCurrentContext()).ToChecked() );
-	}
-	// v8::Local<v8::String>  std::string ɂ
-	template<>
-	static const std::string from_v8(v8::Isolate* isolate, v8::Local<v8::Value> value) {
-		std::string string(*v8::String::Utf8Value(isolate, value));
-		if (0 == string.length()) return "";
-		return std::move(string);
+	// v8::Local<v8::Hoge>  <Dest=double> ɂ
+	// (NX̖Iꉻ GCC ʂȂ̂œȌ^ if constexpr ŐU蕪)
+	template<class Dest = double, class Source = v8::Number>
+	static const Dest from_v8(v8::Isolate* isolate, v8::Local<v8::Value> value) {
+		if constexpr (std::is_same_v<Dest, callback>) {
+			// v8::Local<v8::FunctionTemplate> 𖳗 v8easy::callback ɂ
+			auto context = isolate->GetCurrentContext();
+			auto ft = *reinterpret_cast<v8::Local<v8::FunctionTemplate>*>(const_cast<v8::Local<v8::Value>*>(&value));
+			auto f = ft->GetFunction(context).ToLocalChecked();
+			auto o = (*f)->ToObject(context).ToLocalChecked();
+			object obj(**o);
+			return (callback)obj.get();
+		} else if constexpr (std::is_same_v<Dest, int64_t> && (std::is_same_v<Source, v8::Number> || std::is_same_v<Source, v8::BigInt>)) {
+			// v8::Local<v8::BigInt>  int64_t ɂ
+			return static_cast<int64_t>( v8::Local<v8::BigInt>::Cast(value)->IntegerValue(isolate->GetCurrentContext()).ToChecked() );
+		} else if constexpr (std::is_same_v<Dest, std::string>) {
+			// v8::Local<v8::String>  std::string ɂ
+			std::string string(*v8::String::Utf8Value(isolate, value));
+			return string;
+		} else if constexpr (is_vector<Dest>::value || is_std_array<Dest>::value) {
+			return from_v8_array<Dest>(isolate, value);
+		} else if constexpr (is_string_map<Dest>::value) {
+			return from_v8_map<Dest>(isolate, value);
+		} else if constexpr (std::is_constructible_v<Dest, v8::Local<v8::Value>>) {
+			// array/typed_array ݂ v8::Local<v8::Value> ̂͂ŕ
+			return Dest(value);
+		} else {
+			return static_cast<Dest>( v8::Local<Source>::Cast( value )->Value() );
+		}
+	}
+
+	// Reǐ^ǂ
+	template<class T> struct is_vector : std::false_type {};
+	template<class T, class Allocator> struct is_vector<std::vector<T, Allocator>> : std::true_type {};
+	template<class T> struct is_std_array : std::false_type {};
+	template<class T, size_t N> struct is_std_array<std::array<T, N>> : std::true_type {};
+	template<class T> struct is_string_map : std::false_type {};
+	template<class T> struct is_string_map<std::unordered_map<std::string, T>> : std::true_type {};
+	// C++ ̌^ from_v8 ŌoR V8 ̌^߂ (bool  v8::Number ƂēǂނƉ)
+	template<class T>
+	using v8_type = std::conditional_t<std::is_same_v<T, bool>, v8::Boolean, v8::Number>;
+
+	// double  T ɂ (NaN  0A^ɓȂ̂͒[Ɋ񂹂B̂܂ static_cast Ɩ`)
+	template<class T>
+	static T from_number(double number) {
+		if constexpr (std::is_integral_v<T>) {
+			if (std::isnan(number)) return 0;
+			if (number <= static_cast<double>(std::numeric_limits<T>::lowest())) return std::numeric_limits<T>::lowest();
+			if (static_cast<double>(std::numeric_limits<T>::max()) <= number) return std::numeric_limits<T>::max();
+			return static_cast<T>(number);
+		} else {
+			if (std::isfinite(number) && static_cast<double>(std::numeric_limits<T>::max()) < std::abs(number))
+				return number < 0 ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::infinity();
+			return static_cast<T>(number);
+		}
+	}
+
+	/*
+	 * v8::Array  std::vector<T>/std::array<T, N> ɂ (q)
+	 *
+	 * vflȂ Float64Array ɂ܂Ƃ߂ăRs[Ăǂ (V8 ̒ňCɃRs[Ă̂1 Get 葬)
+	 * Float64Array ̓XNvgɍւĂȂ悤ɁAŏ̃ReLXgɎĂ̂g
+	 * Ȃ1 NumberValue œǂ (ǂ ToNumber Ȃ̂Ōʂ͓)
+	 * ȊO index 1ǂ (L[ v8::Value ɂȂĂ array::get 葬)
+	 */
+	template<class Dest>
+	static Dest from_v8_array(v8::Isolate* isolate, v8::Local<v8::Value> value) {
+		using T = typename Dest::value_type;
+		Dest result{};
+		if (!value->IsArray() && !value->IsTypedArray()) return result;
+
+		auto context = isolate->GetCurrentContext();
+		auto ary = as<v8::Object>(value);
+		size_t length = value->IsArray() ? as<v8::Array>(value)->Length() : as<v8::TypedArray>(value)->Length();
+		if constexpr (is_vector<Dest>::value) {
+			result.resize(length);
+		} else {
+			length = std::min(length, result.size());
+		}
+
+		if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, int64_t>) {
+			// lɂłȂvf (BigInt Ƃ) ͗OOɘR炳 0 ̂܂܂ɂ
+			v8::TryCatch tryCatch(isolate);
+			v8::Local<v8::Value> numbers = value;
+			auto js = instance(isolate);
+			if (!value->IsFloat64Array() && 32 <= length && js && !js->float64_array_constructor.IsEmpty()) {
+				v8::Local<v8::Object> copied;
+				v8::Local<v8::Value> argv[] = { value };
+				if (js->float64_array_constructor.Get(isolate)->NewInstance(context, 1, argv).ToLocal(&copied))
+					numbers = copied;
+			}
+			if (numbers->IsFloat64Array()) {
+				auto source = float64_array(numbers).data();
+				for (size_t i = 0; i < length; ++i)
+					result[i] = from_number<T>(source[i]);
+				return result;
+			}
+			for (uint32_t i = 0; i < length; ++i) {
+				v8::Local<v8::Value> element;
+				double number;
+				if (ary->Get(context, i).ToLocal(&element) && element->NumberValue(context).To(&number))
+					result[i] = from_number<T>(number);
+			}
+			return result;
+		}
+
+		for (uint32_t i = 0; i < length; ++i) {
+			v8::Local<v8::Value> element;
+			if (ary->Get(context, i).ToLocal(&element))
+				result[i] = from_v8<T, v8_type<T>>(isolate, element);
+		}
+		return result;
+	}
+
+	// v8::Object  std::unordered_map<std::string, T> ɂ (q)
+	template<class Dest>
+	static Dest from_v8_map(v8::Isolate* isolate, v8::Local<v8::Value> value) {
+		using T = typename Dest::mapped_type;
+		Dest result;
+		if (!value->IsObject()) return result;
+
+		auto context = isolate->GetCurrentContext();
+		auto object = as<v8::Object>(value);
+		v8::Local<v8::Array> keys;
+		if (!object->GetOwnPropertyNames(context).ToLocal(&keys)) return result;
+		result.reserve(keys->Length());
+		for (uint32_t i = 0; i < keys->Length(); ++i) {
+			v8::Local<v8::Value> key, element;
+			if (!keys->Get(context, i).ToLocal(&key) || !object->Get(context, key).ToLocal(&element)) continue;
+			result.emplace(from_v8<std::string>(isolate, key), from_v8<T, v8_type<T>>(isolate, element));
+		}
+		return result;
+	}
+
+	/*
+	 * xgvpeB (internalize ς݂ v8::String  isolate I܂ŎĂ)
+	 *
+	 * static v8easy::key name(isolate, "name"); Ă΁Aarray::get(name) ͕Ȃ
+	 * ( isolate łgȂ)
+	 */
+	class key {
+		v8::Eternal<v8::String> handle;
+	public:
+		key(v8::Isolate* isolate, const std::string& name) : handle(isolate, intern(isolate, name)) {}
+		key(v8::Isolate* isolate, v8::Local<v8::String> name) : handle(isolate, name) {}
+		v8::Local<v8::String> get(v8::Isolate* isolate) const { return handle.Get(isolate); }
+	};
+
+	// isolate ɌѕtĂ v8easy ( nullptr)
+	static v8easy* instance(v8::Isolate* isolate) {
+		return static_cast<v8easy*>(isolate->GetData(isolate_slot()));
+	}
+	static uint32_t isolate_slot() { return v8::Isolate::GetNumberOfDataSlots() - 1; }
+
+	/*
+	 * std::string ̃vpeB internalize ς݂ v8::String ɂ
+	 *
+	 * v8easy  isolate Ȃ̂oĂāA瓯O͕炸ɕԂ
+	 * (oĂ̂ interned_keys_max ܂ŁAȏ͖)
+	 */
+	static v8::Local<v8::String> intern(v8::Isolate* isolate, const std::string& name) {
+		auto self = instance(isolate);
+		if (self) {
+			auto found = self->interned_keys.find(name);
+			if (self->interned_keys.end() != found)
+				return found->second.Get(isolate);
+		}
+		auto string = v8::String::NewFromUtf8(isolate, name.data(), v8::NewStringType::kInternalized, static_cast<int>(name.size())).ToLocalChecked();
+		if (self && self->interned_keys.size() < interned_keys_max)
+			self->interned_keys.emplace(name, v8::Eternal<v8::String>(isolate, string));
+		return string;
 	}
 
+	// vpeB̃L[ɂ ( internalize ς݂̂̂g)
+	static v8::Local<v8::Value> to_key(v8::Isolate* isolate, const v8easy::key& name) { return name.get(isolate); }
+	static v8::Local<v8::Value> to_key(v8::Isolate* isolate, const std::string& name) { return intern(isolate, name); }
+	static v8::Local<v8::Value> to_key(v8::Isolate* isolate, const char* name) { return intern(isolate, name); }
+	template<class Key>
+	static v8::Local<v8::Value> to_key(v8::Isolate* isolate, const Key& name) { return to_v8(isolate, name); }
+
 	/*  namespace  */
 	class array;
 	/*
@@ -127,35 +357,78 @@ public:
 	class element {
 	public:
 		array* _array;
+		// begin() 1񂾂L[̈ꗗ (v8::Array ̎͋ŁAindex ̂܂܃L[)
+		v8::Local<v8::Array> _keys;
 		const uint32_t index;
 
+		// L[̂܂ v8::Value Ŏ擾
+		v8::Local<v8::Value> raw_key() {
+			auto isolate = v8::Isolate::GetCurrent();
+			v8::Local<v8::Value> result;
+			if (_keys.IsEmpty())
+				return v8::Integer::NewFromUnsigned(isolate, index);
+			if (!_keys->Get(isolate->GetCurrentContext(), index).ToLocal(&result))
+				return v8::Undefined(isolate);
+			return result;
+		}
+
 		// L[ any(default=uint32_t) Ŏ擾
 		template<class Dest = uint32_t, class Source = v8::Number>
 		Dest key() {
-			return (*_array).keys().get<Dest, Source>(index);
+			if constexpr (std::is_integral_v<Dest>) {
+				if (_keys.IsEmpty()) return static_cast<Dest>(index);
+			}
+			return from_v8<Dest, Source>(v8::Isolate::GetCurrent(), raw_key());
 		}
 
 		// L[ any(default=uint32_t)  any(default=double) 擾
+		// (L[͕ϊɂ̂܂܎ĝ KeyDest/KeySource ͌݊̂߂ɂ)
 		template<class Dest = double, class Source = v8::Number, class KeyDest = uint32_t, class KeySource = v8::Number>
 		Dest get() {
-			return (*_array).get<Dest, Source>( key<KeyDest, KeySource>() );
+			if (_keys.IsEmpty()) return (*_array).get<Dest, Source>(index);
+			return (*_array).get<Dest, Source>(raw_key());
 		}
 
 		// L[ any(default=uint32_t)  any(default=double) 
 		template<class Source = double, class Dest = v8::Number, class KeyDest = uint32_t, class KeySource = v8::Number>
 		void set(Source value) {
-			(*_array).set<Source, Dest>(key<KeyDest, KeySource>(), value);
+			if (_keys.IsEmpty()) return (*_array).set<Source, Dest>(index, value);
+			(*_array).set<Source, Dest>(raw_key(), value);
 		}
 	};
 
+	// begin() L[̈ꗗƏÏʒuĉ (end() ͉ȂڈŁAary  nullptr)
 	class array_iterator {
 	public:
 		array* ary;
+		v8::Local<v8::Array> keys;
 		uint32_t index = 0;
-		element operator*() { return (*ary).at(index); }
+		uint32_t count = 0;
+		element operator*() { return { ary, keys, index }; }
 		array_iterator& operator++() { ++index; return *this; }
-		bool operator!=(const array_iterator& it) { return index != it.index; }
+		bool operator!=(const array_iterator& it) { return index != (it.ary ? it.index : count); }
+	};
+
+	// L[ƒl^t std::pair ŕԂCe[^
+	template<class Key, class Value>
+	class item_iterator {
+	public:
+		array_iterator it;
+		std::pair<Key, Value> operator*() {
+			element e = *it;
+			return { e.key<Key, v8_type<Key>>(), e.get<Value, v8_type<Value>>() };
+		}
+		item_iterator& operator++() { ++it; return *this; }
+		bool operator!=(const item_iterator& other) { return it != other.it; }
+	};
+	template<class Key, class Value>
+	class item_range {
+	public:
+		array* ary;
+		item_iterator<Key, Value> begin() { return { (*ary).begin() }; }
+		item_iterator<Key, Value> end() { return { (*ary).end() }; }
 	};
+
 	/*
 	 * v8 ̔z{v8::Local<v8::Array>}ւ̃ANZX̂߂̃NX
 	 *
@@ -174,30 +447,64 @@ public:
 		// L[ any(default=uint32_t)  object bsOĎ擾
 		template<class KeySource = double, class KeyDest = v8::Number>
 		array get_array(KeySource key) {
-			return { (*this)->Get( to_v8(v8::Isolate::GetCurrent(), key)) };
+			return { lookup(v8::Isolate::GetCurrent(), key) };
 		}
 
 		// L[ any(default=uint32_t)  any(default=double) 擾
+		// (̃L[ internalize ς݂̂̂g񂷁Av8easy::key nƕȂ)
 		template<class Dest = double, class Source = v8::Number, class KeySource = uint32_t, class KeyDest = v8::Number>
 		Dest get(KeySource key) {
-			return from_v8<Dest, Source>(
-				v8::Isolate::GetCurrent(),
-				(*this)->Get( to_v8(v8::Isolate::GetCurrent(), key) )
-			);
+			auto isolate = v8::Isolate::GetCurrent();
+			return from_v8<Dest, Source>(isolate, lookup(isolate, key));
 		}
 
 		// L[ any(default=uint32_t)  any(default=int64_t) 
 		template<class Source = double, class Dest = v8::Number, class KeySource = uint32_t, class KeyDest = v8::Number>
 		void set(KeySource key, Source value) {
-			(*this)->Set(
-				to_v8<KeySource, KeyDest>(v8::Isolate::GetCurrent(), key),
-				to_v8(v8::Isolate::GetCurrent(), value)
-			);
+			auto isolate = v8::Isolate::GetCurrent();
+			auto context = isolate->GetCurrentContext();
+			if constexpr (std::is_integral_v<KeySource>) {
+				(*this)->Set(context, static_cast<uint32_t>(key), to_v8(isolate, value)).FromMaybe(false);
+			} else {
+				(*this)->Set(context, to_key(isolate, key), to_v8(isolate, value)).FromMaybe(false);
+			}
+		}
+
+		// ̃L[ v8::Value ɂ index Ŏ
+		template<class KeySource>
+		v8::Local<v8::Value> lookup(v8::Isolate* isolate, const KeySource& key) {
+			auto context = isolate->GetCurrentContext();
+			v8::Local<v8::Value> result;
+			if constexpr (std::is_integral_v<KeySource>) {
+				if (!(*this)->Get(context, static_cast<uint32_t>(key)).ToLocal(&result)) return v8::Undefined(isolate);
+			} else {
+				if (!(*this)->Get(context, to_key(isolate, key)).ToLocal(&result)) return v8::Undefined(isolate);
+			}
+			return result;
 		}
 
-		const element& at(uint32_t index) { return { this, index }; }
-		array_iterator begin() noexcept { return { this, 0 }; }
-		array_iterator end() noexcept { return { this, length() }; }
+		/*
+		 * for (auto&& e : ary) ŉ񂷎 begin() ŃL[̈ꗗ1񂾂ăCe[^Ɏ
+		 * (񂷂тɎ蒼̂ŁAO̎̌ɑL[Bv8::Array ̎̓L[炸 index ŉ)
+		 * at() ͌ĂԂтɃL[̈ꗗ̂ŁASȂ for ŉ
+		 */
+		element at(uint32_t index) {
+			return { this, snapshot_keys(), index };
+		}
+		array_iterator begin() {
+			auto keys = snapshot_keys();
+			return { this, keys, 0, keys.IsEmpty() ? length() : keys->Length() };
+		}
+		array_iterator end() { return { nullptr, {}, 0, 0 }; }
+		// for (auto&& [key, value] : ary.items<std::string, double>()) ݂ɃL[ƒlꏏɎ
+		template<class Key = std::string, class Value = double>
+		item_range<Key, Value> items() { return { this }; }
+
+	private:
+		v8::Local<v8::Array> snapshot_keys() {
+			if ((*this)->IsArray()) return {};
+			return keys();
+		}
 	};
 
 	/*
@@ -211,11 +518,373 @@ public:
 		// v8::Value  Dest ֕ϊ
 		template<class Dest = double, class Source = v8::Number>
 		Dest get() { return from_v8<Dest, Source>(v8::Isolate::GetCurrent(), *this ); }
+	};
+
+	/*
+	 * std::span ̑ (C++17 łg悤ɍŒ)
+	 */
+	template<class T>
+	class span {
+		T* pointer = nullptr;
+		size_t count = 0;
+	public:
+		span() = default;
+		span(T* pointer, size_t count) : pointer(pointer), count(count) {}
+
+		T* data() const { return pointer; }
+		size_t size() const { return count; }
+		bool empty() const { return 0 == count; }
+		T& operator[](size_t index) const { return pointer[index]; }
+		T* begin() const { return pointer; }
+		T* end() const { return pointer + count; }
+	};
+
+	/*
+	 * v8::ArrayBuffer ̒g𒼐ړǂݏ邽߂̃NX
+	 */
+	class array_buffer : public v8::Local<v8::ArrayBuffer> {
+#if V8_MAJOR_VERSION < 8
+		// wrap()  GC ɉꂽɕԂ߂̏ (V8 7 )
+		struct external_memory {
+			v8::Global<v8::ArrayBuffer> handle;
+			void* data;
+			size_t length;
+			std::function<void(void*, size_t)> deleter;
+		};
+#endif
+
+	public:
+		array_buffer(v8::Local<v8::Value> buffer) : v8::Local<v8::ArrayBuffer>( v8::Local<v8::ArrayBuffer>::Cast(buffer) ) {}
+		// length oCgmۂč (g 0 Ŗ܂Ă)
+		array_buffer(v8::Isolate* isolate, size_t length) : v8::Local<v8::ArrayBuffer>( v8::ArrayBuffer::New(isolate, length) ) {}
+
+		/*
+		 * C++ Ă郁Rs[ ArrayBuffer ƂČ
+		 *
+		 * vȂȂ deleter(data, length) Ă΂
+		 * V8 8  BackingStore ꂽ V8 Ă (js ̃IuWFNgɂȂ邱Ƃ邵Aʂ̃XbhĂ΂邱Ƃ)
+		 * V8 7  GC ɉꂽɌĂ΂ (isolate ɔjƌĂ΂Ȃ̂ŁȀꍇ͎ŉ)
+		 */
+		static array_buffer wrap(v8::Isolate* isolate, void* data, size_t length, std::function<void(void*, size_t)> deleter = nullptr) {
+#if V8_MAJOR_VERSION < 8
+			array_buffer buffer( v8::ArrayBuffer::New(isolate, data, length, v8::ArrayBufferCreationMode::kExternalized) );
+			auto memory = new external_memory{ v8::Global<v8::ArrayBuffer>(isolate, buffer), data, length, std::move(deleter) };
+			// 1ڂ̃R[obNł Reset() Ă͂Ȃ̂ŁA2ڂł
+			memory->handle.SetWeak(memory, [](const v8::WeakCallbackInfo<external_memory>& info) {
+				info.GetParameter()->handle.Reset();
+				info.SetSecondPassCallback([](const v8::WeakCallbackInfo<external_memory>& info) {
+					auto memory = info.GetParameter();
+					info.GetIsolate()->AdjustAmountOfExternalAllocatedMemory(-static_cast<int64_t>(memory->length));
+					if (memory->deleter) memory->deleter(memory->data, memory->length);
+					delete memory;
+				});
+			}, v8::WeakCallbackType::kParameter);
+			// GC ɊOŎĂ郁̗ʂƂȂƉɂ
+			isolate->AdjustAmountOfExternalAllocatedMemory(static_cast<int64_t>(length));
+			return buffer;
+#else
+			// Õ̗ʂ BackingStore ̕Ƃ V8 Ă
+			auto holder = deleter ? new std::function<void(void*, size_t)>(std::move(deleter)) : nullptr;
+			auto store = v8::ArrayBuffer::NewBackingStore(data, length, [](void* data, size_t length, void* holder) {
+				if (!holder) return;
+				auto deleter = static_cast<std::function<void(void*, size_t)>*>(holder);
+				(*deleter)(data, length);
+				delete deleter;
+			}, holder);
+			return { v8::ArrayBuffer::New(isolate, std::move(store)) };
+#endif
+		}
+
+		size_t length() { return (*this)->ByteLength(); }
+		span<uint8_t> data() { return as<uint8_t>(); }
+		// g T ̕тƂČ
+		template<class T>
+		span<T> as() {
+#if V8_MAJOR_VERSION < 8
+			auto contents = (*this)->GetContents();
+#else
+			auto backing = (*this)->GetBackingStore();
+			auto& contents = *backing;
+#endif
+			return { static_cast<T*>(contents.Data()), contents.ByteLength() / sizeof(T) };
+		}
+	};
+
+	/*
+	 * v8::{Float64,Int32,Uint8}Array ̒g𒼐ړǂݏ邽߂̃NX
+	 *
+	 * data() ̓Rs[ ArrayBuffer ̒ŵŁAƂ̂܂ js ɂ
+	 */
+	template<class T, class V8Array>
+	class typed_array : public v8::Local<V8Array> {
+	public:
+		typed_array(v8::Local<v8::Value> ary) : v8::Local<V8Array>( v8::Local<V8Array>::Cast(ary) ) {}
+		// length mۂč
+		typed_array(v8::Isolate* isolate, size_t length)
+			: v8::Local<V8Array>( V8Array::New(v8::ArrayBuffer::New(isolate, length * sizeof(T)), 0, length) ) {}
+		// ɂ array_buffer  offset oCgڂ length 
+		typed_array(v8::Local<v8::ArrayBuffer> buffer, size_t offset, size_t length)
+			: v8::Local<V8Array>( V8Array::New(buffer, offset, length) ) {}
+
+		size_t length() { return (*this)->Length(); }
+		array_buffer buffer() { return { (*this)->Buffer() }; }
+		span<T> data() {
+			// z̓q[v̒ɂ邯 Buffer() ĂԂƃq[v̊OɏoĂ
+#if V8_MAJOR_VERSION < 8
+			auto contents = (*this)->Buffer()->GetContents();
+#else
+			auto backing = (*this)->Buffer()->GetBackingStore();
+			auto& contents = *backing;
+#endif
+			return { reinterpret_cast<T*>(static_cast<char*>(contents.Data()) + (*this)->ByteOffset()), length() };
+		}
+	};
+	using float64_array = typed_array<double, v8::Float64Array>;
+	using int32_array = typed_array<int32_t, v8::Int32Array>;
+	using uint8_array = typed_array<uint8_t, v8::Uint8Array>;
+
+	/*
+	 * ܂Ƃ߂ĊmۂĂ܂Ƃ߂Ď̂Ă邾̃ (variant ̖؂̒uꏊ)
+	 *
+	 * 1̉͂łȂǁAmۂ͒[؂oȂ̂ő
+	 */
+	class arena {
+		std::vector<std::unique_ptr<char[]>> blocks;
+		char* cursor = nullptr;
+		size_t left = 0;
+		size_t total = 0;
+		const size_t block_size;
+
+	public:
+		arena(size_t block_size = 64 * 1024) : block_size(block_size) {}
+		arena(const arena&) = delete;
+		arena& operator=(const arena&) = delete;
+		arena(arena&&) = default;
+
+		void* allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+			size_t padding = (align - reinterpret_cast<uintptr_t>(cursor) % align) % align;
+			if (left < size + padding) {
+				// 傫̂͂p̃ubNɂ
+				size_t length = std::max(block_size, size + align);
+				blocks.emplace_back(new char[length]);
+				cursor = blocks.back().get();
+				left = length;
+				total += length;
+				padding = (align - reinterpret_cast<uintptr_t>(cursor) % align) % align;
+			}
+			void* result = cursor + padding;
+			cursor += padding + size;
+			left -= padding + size;
+			return result;
+		}
+		// T  count  (T ̓fXgN^Ă΂ȂĂ̂)
+		template<class T>
+		T* make(size_t count) {
+			static_assert(std::is_trivially_destructible_v<T>, "arena never calls destructors");
+			T* result = static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+			for (size_t i = 0; i < count; ++i)
+				new (result + i) T();
+			return result;
+		}
+		// ŜĂ
+		void clear() {
+			blocks.clear();
+			cursor = nullptr;
+			left = total = 0;
+		}
+		size_t size() const { return total; }
+	};
+
+	/*
+	 * JS ̒l C++ ̖؂ɂ (null/bool/number/bigint/string/array/object)
+	 *
+	 * qvf document  arena ̒ɂ̂ŁAdocument 蒷Ȃ
+	 */
+	class variant {
+	public:
+		enum class type : uint8_t { null, boolean, number, bigint, string, array, object };
+
+		type kind = type::null;
+		union {
+			bool boolean;
+			double number;
+			int64_t bigint;
+		};
+		std::string_view string;
+		// array/object ̎qvf (object ̎ keys )
+		uint32_t length = 0;
+		variant* values = nullptr;
+		std::string_view* keys = nullptr;
+
+		variant() : bigint(0) {}
 
-		// v8::Local<v8::Value> ւ̕ϊ
-		operator v8::Local<v8::Value>() { return *this; }
+		bool is_null() const { return type::null == kind; }
+		size_t size() const { return length; }
+		const variant& operator[](size_t index) const { return values[index]; }
+		// object ̃L[ŒT ( nullptr)
+		const variant* find(std::string_view key) const {
+			for (uint32_t i = 0; type::object == kind && i < length; ++i)
+				if (keys[i] == key) return &values[i];
+			return nullptr;
+		}
+		const variant* begin() const { return values; }
+		const variant* end() const { return values + length; }
+	};
+
+	/*
+	 * variant ̖؂Ƃ̒uꏊ
+	 */
+	class document {
+	public:
+		v8easy::arena arena;
+		variant root;
 	};
 
+	/*
+	 * JS ̒l variant ̖؂ɂ (1Ȃ߂邾ŕϊ)
+	 *
+	 * zQ/maxDepth [/int64_t ɓȂ BigInt ̎ false Ԃ printBuffer ɗR
+	 * ֐/V{/undefined  null ɂȂ
+	 */
+	static bool to_variant(v8::Isolate* isolate, v8::Local<v8::Value> value, document& dest, std::string& printBuffer, uint32_t maxDepth = 128) {
+		std::vector<v8::Local<v8::Object>> ancestors;
+		dest.arena.clear();
+		dest.root = variant();
+		return to_variant(isolate, isolate->GetCurrentContext(), value, dest.root, dest.arena, ancestors, printBuffer, maxDepth);
+	}
+
+private:
+	static bool to_variant(
+		v8::Isolate* isolate, v8::Local<v8::Context> context, v8::Local<v8::Value> value, variant& dest, arena& memory,
+		std::vector<v8::Local<v8::Object>>& ancestors, std::string& printBuffer, uint32_t maxDepth
+	) {
+		if (value->IsBoolean()) {
+			dest.kind = variant::type::boolean;
+			dest.boolean = value->IsTrue();
+		} else if (value->IsNumber()) {
+			dest.kind = variant::type::number;
+			dest.number = as<v8::Number>(value)->Value();
+		} else if (value->IsBigInt()) {
+			bool lossless = true;
+			dest.kind = variant::type::bigint;
+			dest.bigint = as<v8::BigInt>(value)->Int64Value(&lossless);
+			if (!lossless) {
+				printBuffer = "to_variant: BigInt does not fit in int64_t";
+				return false;
+			}
+		} else if (value->IsString()) {
+			auto string = as<v8::String>(value);
+			int length = string->Utf8Length(isolate);
+			char* buffer = static_cast<char*>(memory.allocate(length, 1));
+			string->WriteUtf8(isolate, buffer, length, nullptr, v8::String::NO_NULL_TERMINATION | v8::String::REPLACE_INVALID_UTF8);
+			dest.kind = variant::type::string;
+			dest.string = std::string_view(buffer, length);
+		} else if (value->IsObject() && !value->IsFunction()) {
+			auto object = as<v8::Object>(value);
+			for (auto& ancestor : ancestors) {
+				if (ancestor == object) {
+					printBuffer = "to_variant: circular reference";
+					return false;
+				}
+			}
+			if (maxDepth <= ancestors.size()) {
+				printBuffer = "to_variant: nesting is deeper than " + std::to_string(maxDepth);
+				return false;
+			}
+
+			ancestors.push_back(object);
+			v8::Local<v8::Array> names;
+			if (value->IsArray()) {
+				dest.kind = variant::type::array;
+				dest.length = as<v8::Array>(value)->Length();
+			} else {
+				dest.kind = variant::type::object;
+				if (!object->GetOwnPropertyNames(
+					context, static_cast<v8::PropertyFilter>(v8::ONLY_ENUMERABLE | v8::SKIP_SYMBOLS), v8::KeyConversionMode::kConvertToString
+				).ToLocal(&names)) {
+					printBuffer = "to_variant: could not get property names";
+					return false;
+				}
+				dest.length = names->Length();
+				dest.keys = memory.make<std::string_view>(dest.length);
+			}
+			dest.values = memory.make<variant>(dest.length);
+
+			for (uint32_t i = 0; i < dest.length; ++i) {
+				// vfƂɃnĥĂȂƑ傫zŃnh܂
+				v8::HandleScope handle_scope(isolate);
+				v8::Local<v8::Value> child;
+				if (names.IsEmpty()) {
+					if (!object->Get(context, i).ToLocal(&child)) {
+						printBuffer = "to_variant: could not get element";
+						return false;
+					}
+				} else {
+					v8::Local<v8::Value> name;
+					if (!names->Get(context, i).ToLocal(&name) || !object->Get(context, name).ToLocal(&child)) {
+						printBuffer = "to_variant: could not get property";
+						return false;
+					}
+					variant key;
+					to_variant(isolate, context, name, key, memory, ancestors, printBuffer, maxDepth);
+					dest.keys[i] = key.string;
+				}
+				if (!to_variant(isolate, context, child, dest.values[i], memory, ancestors, printBuffer, maxDepth))
+					return false;
+			}
+			ancestors.pop_back();
+		} else {
+			dest.kind = variant::type::null;
+		}
+		return true;
+	}
+
+public:
+	// variant ̖؂ JS ̒lɖ߂
+	static v8::Local<v8::Value> to_v8(v8::Isolate* isolate, const variant& value) {
+		v8::EscapableHandleScope handle_scope(isolate);
+		v8::Local<v8::Value> result;
+		switch (value.kind) {
+		case variant::type::null:
+			result = v8::Null(isolate);
+			break;
+		case variant::type::boolean:
+			result = v8::Boolean::New(isolate, value.boolean);
+			break;
+		case variant::type::number:
+			result = v8::Number::New(isolate, value.number);
+			break;
+		case variant::type::bigint:
+			result = v8::BigInt::New(isolate, value.bigint);
+			break;
+		case variant::type::string:
+			result = v8::String::NewFromUtf8(isolate, value.string.data(), v8::NewStringType::kNormal, static_cast<int>(value.string.size())).ToLocalChecked();
+			break;
+		case variant::type::array: {
+			std::vector<v8::Local<v8::Value>> elements;
+			elements.reserve(value.length);
+			for (auto& element : value)
+				elements.push_back(to_v8(isolate, element));
+			result = v8::Array::New(isolate, elements.data(), elements.size());
+			break;
+		}
+		case variant::type::object: {
+			auto context = isolate->GetCurrentContext();
+			auto object = v8::Object::New(isolate);
+			for (uint32_t i = 0; i < value.length; ++i)
+				object->CreateDataProperty(
+					context,
+					// intern() ̕\ɓƁAJSON R̎ĝẴL[ŕ\cނ̂ V8  internalize g
+					v8::String::NewFromUtf8(isolate, value.keys[i].data(), v8::NewStringType::kInternalized, static_cast<int>(value.keys[i].size())).ToLocalChecked(),
+					to_v8(isolate, value.values[i])
+				).FromMaybe(false);
+			result = object;
+			break;
+		}
+		}
+		return handle_scope.Escape(result);
+	}
+
 	/*
 	 * v8::Function ĂԂ̂ɂȂɏȂႢȂƂ߂ǂˁHȃNX
 	 *
@@ -223,7 +892,7 @@ public:
 	 */
 	class function : public v8::Local<v8::Object> {
 	public:
-		function(v8::Local<v8::Value> object) : v8::Local<v8::Object>( object->ToObject(v8::Isolate::GetCurrent()) ) {}
+		function(v8::Local<v8::Value> object) : v8::Local<v8::Object>( object->ToObject(v8::Isolate::GetCurrent()->GetCurrentContext()).ToLocalChecked() ) {}
 
 		template<class Source = double, class Dest = v8::Number>
 		Source call(int argc, v8easy::value* argv) {
@@ -257,11 +926,6 @@ public:
 		Dest get(int index) {
 			return from_v8<Dest, Source>( this->GetIsolate(), at(index) );
 		}
-		// :get:v8easy:value
-		template<>
-		function get(int index) {
-			return { at(index) };
-		}
 		// get:v8easy:array
 		array get(int index) {
 			return { at(index) };
@@ -278,185 +942,2859 @@ public:
 		}
 	};
 
-private:
 	/*
-	 * v8::HandleScope qNXł new ĂȂ(delete폜)̂ŎdȂɃNX
+	 * ֐̌^Ɩ߂ľ^o (֐|C^/o֐|C^/_/֐IuWFNg)
 	 */
-	class scopes {
-	public:
-		v8::Isolate::Scope isolate_scope;
-		v8::HandleScope handle_scope;
-		scopes(v8::Isolate* isolate) : isolate_scope(isolate), handle_scope(isolate) {}
+	template<class Function>
+	struct signature : signature<decltype(&Function::operator())> {};
+	template<class Result, class... Args>
+	struct signature<Result(*)(Args...)> {
+		using result = Result;
+		using arguments = std::tuple<std::decay_t<Args>...>;
 	};
+	template<class Result, class Class, class... Args>
+	struct signature<Result(Class::*)(Args...)> : signature<Result(*)(Args...)> {};
+	template<class Result, class Class, class... Args>
+	struct signature<Result(Class::*)(Args...) const> : signature<Result(*)(Args...)> {};
 
-	std::unique_ptr<v8::Platform> platform;
-	v8::Isolate::CreateParams create_params;
-
-	v8::Isolate* global_isolate;
-	v8::Local<v8::ObjectTemplate> global_object;
-	v8::Local<v8::Context> global_context, run_context;
-	scopes* global_scopes;
+	/*
+	 * Ԃ̕z (2̗ݏimbƂɐ)
+	 */
+	class histogram {
+	public:
+		inline static const size_t buckets = 40;
+		uint64_t count = 0;
+		std::chrono::nanoseconds total{ 0 };
+		std::chrono::nanoseconds min{ std::chrono::nanoseconds::max() };
+		std::chrono::nanoseconds max{ 0 };
+		std::array<uint64_t, buckets> counts{};
 
-public:
-	v8easy(char* exePath) {
-		/*
-		 V8 rhƍĂȂIvVIׂ邯 {v8_use_external_startup_data = false}
-		łȂ̂ natives_blob.bin/snapshot_blob.bin fBNgw肵ČĂяoKv
-		ڍ:https://groups.google.com/forum/m/#!topic/v8-users/N4GGCkuKnfA
-		*/
-		v8::V8::InitializeICUDefaultLocation(exePath);
-		v8::V8::InitializeExternalStartupData(exePath);
-		// ̏O isolate ̍쐬̂ƂŗOē{
-		platform = v8::platform::NewDefaultPlatform();
-		v8::V8::InitializePlatform(platform.get());
-		v8::V8::Initialize();
+		void record(std::chrono::nanoseconds elapsed) {
+			size_t bucket = 0;
+			for (auto ns = elapsed.count(); 1 < ns && bucket + 1 < buckets; ns >>= 1) ++bucket;
+			++counts[bucket];
+			++count;
+			total += elapsed;
+			min = std::min(min, elapsed);
+			max = std::max(max, elapsed);
+		}
+		std::chrono::nanoseconds mean() const {
+			return count ? total / static_cast<int64_t>(count) : std::chrono::nanoseconds(0);
+		}
+		// rate (0.5 Ƃ 0.99) ̏ĂԂ̏[ (Ȃ̂ōő2{炢傫߂ɏo)
+		std::chrono::nanoseconds percentile(double rate) const {
+			uint64_t seen = 0, target = static_cast<uint64_t>(rate * count);
+			for (size_t i = 0; i < buckets; ++i) {
+				seen += counts[i];
+				if (count && target < seen)
+					return std::min(max, std::chrono::nanoseconds(static_cast<int64_t>(1) << (i + 1)));
+			}
+			return max;
+		}
+	};
 
-		// isolate Ƃz݂Ȃ̂Ȃ js słȂ炵Aisolate ̓}`pɕ쐬ł
-		create_params.array_buffer_allocator = v8::ArrayBuffer::Allocator::NewDefaultAllocator();
-		global_isolate = v8::Isolate::New(create_params);
-		global_isolate->Enter();
+	/*
+	 * XR[v𔲂܂ł̎Ԃ histogram ɓ (nullptr Ȃ牽Ȃ)
+	 */
+	class timer {
+		histogram* target;
+		std::chrono::steady_clock::time_point start;
+	public:
+		timer(histogram* target) : target(target) {
+			if (target) start = std::chrono::steady_clock::now();
+		}
+		~timer() {
+			if (target) target->record(std::chrono::steady_clock::now() - start);
+		}
+	};
 
-		// XR[ṽX^bNƂȂƂ(͏I܂ŕێĂȂƑʖ)
-		global_scopes = new scopes(global_isolate);
+	/*
+	 * set() ɓnꂽ֐IuWFNg̓ꕨ
+	 *
+	 * FunctionTemplate ̃f[^(v8::External)Ƃă|C^nĂāAĂ΂ꂽɎo
+	 */
+	class bound_base {
+	public:
+		virtual ~bound_base() = default;
+		// ܂Ă鎞͒gԂ (timed_callback p)
+		virtual bound_base* target() { return this; }
+	};
 
-		//  global_object (__main__݂Ȃ)ɐFXȊ֐\tĂ
-		global_object = v8::ObjectTemplate::New(global_isolate);
+	//  function ̌^ɍ킹ĎoČĂŁA߂lԂ
+	template<class Function, size_t... Index>
+	static void apply(Function& function, argument& args, std::index_sequence<Index...>) {
+		using arguments = typename signature<Function>::arguments;
+		using result = typename signature<Function>::result;
+		if constexpr (std::is_void_v<result>) {
+			function(args.get<std::tuple_element_t<Index, arguments>, v8_type<std::tuple_element_t<Index, arguments>>>(Index)...);
+		} else {
+			args.result(function(args.get<std::tuple_element_t<Index, arguments>, v8_type<std::tuple_element_t<Index, arguments>>>(Index)...));
+		}
 	}
-	~v8easy() {
-		delete global_scopes;
-		global_isolate->Exit();
-		global_isolate->Dispose();
-		v8::V8::Dispose();
-		v8::V8::ShutdownPlatform();
-		delete create_params.array_buffer_allocator;
+	template<class Function>
+	static void apply(Function& function, argument& args) {
+		apply(function, args, std::make_index_sequence<std::tuple_size_v<typename signature<Function>::arguments>>());
 	}
 
-	// isolateOقꍇ
-	operator v8::Isolate*() const { return global_isolate; }
-
-	void printException(v8::TryCatch& tryCatch, std::string& printBuffer) {
-		auto message = tryCatch.Message();
-		if (message.IsEmpty()) return;
-		auto fileName();
-		// print {fileName}:line({line}):col({column begin}-{end}): {message}.
-		printBuffer
-			= from_v8<std::string>(v8::Isolate::GetCurrent(), message->GetScriptOrigin().ResourceName() )
-			+":line("+ std::to_string(message->GetLineNumber(v8::Isolate::GetCurrent()->GetCurrentContext()).FromJust() ) +")"
-			+":col("+ std::to_string(message->GetStartColumn()) +"-"+ std::to_string(message->GetEndColumn()) +")"
-			+": "+ from_v8<std::string>(v8::Isolate::GetCurrent(), as<v8::String>(tryCatch.Exception()) );
-	}
+	template<class Function>
+	class bound_function : public bound_base {
+		Function function;
 
-	void useContext(v8::Local<v8::Context>& context) {
-		// s/RpCۂɃReLXgKv݂B(ꖈXR[vƓoō쐬ƃň)
-		// TODO: C++ global_object ɓ\tOɍ쐬ēKpƁA
-		// C++ō쐬IuWFNgȂȂ(܂킩)
-		if (context.IsEmpty()) {
-			context = v8::Context::New(global_isolate, nullptr, global_object);
-		}
-	}
+	public:
+		bound_function(Function function) : function(std::move(function)) {}
 
-	// t@C v8 ̎擾
-	v8::MaybeLocal<v8::String> read(const std::string& fileName) {
-		std::string _fileName;
-		std::vector<char> ignores = { ' ', '\"', '\'' };
-		if (fileName.length()) {
-			for (auto& ignore : ignores) {
-				if (ignore == fileName[0])
-					_fileName.assign(fileName.begin(), fileName.end() - 1);
-				if (ignore == fileName[fileName.length() - 1])
-					_fileName.assign(fileName.begin(), fileName.end() - 1);
+		static void invoke(const v8::FunctionCallbackInfo<v8::Value>& info) {
+			auto self = static_cast<bound_function*>(static_cast<bound_base*>(as<v8::External>(info.Data())->Value())->target());
+			argument args(const_cast<v8::FunctionCallbackInfo<v8::Value>&>(info));
+			if constexpr (std::is_invocable_v<Function&, argument&>) {
+				// void(v8easy::argument&) ̌`Ȃ炻̂܂ܓn (Lv`t_p)
+				self->function(args);
+			} else {
+				// ȊO͈^ɍ킹ĎoāA߂lԂ
+				apply(self->function, args);
 			}
 		}
+	};
 
-		v8::Local<v8::String> v8_source;
-		std::ifstream ifs(_fileName, std::ios::in | std::ios::binary);
-		std::string source;
-		if (ifs.fail()) {
-			// t@Cǂݍ߂Ȃ / t@CȂ
-			return as<v8::String>(to_v8(global_isolate, ""));
+	/*
+	 * set() ֐gNXpɕ񂾂 (Ăяo̎Ԃ stats ɓ)
+	 *
+	 * ܂ꂽ target() Ŏ̃f[^ôŁAdata t̊֐̂܂܌Ăׂ
+	 */
+	class timed_callback : public bound_base {
+		v8::FunctionCallback callback;
+		std::shared_ptr<bound_base> inner;
+		histogram* stats;
+	public:
+		timed_callback(v8::FunctionCallback callback, std::shared_ptr<bound_base> inner, histogram* stats)
+			: callback(callback), inner(std::move(inner)), stats(stats) {}
+		bound_base* target() override { return inner ? inner->target() : this; }
+
+		static void invoke(const v8::FunctionCallbackInfo<v8::Value>& info) {
+			auto self = static_cast<timed_callback*>(static_cast<bound_base*>(as<v8::External>(info.Data())->Value()));
+			timer measure(self->stats);
+			self->callback(info);
 		}
-		source.assign((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+	};
 
-		return as<v8::String>(
-			to_v8(global_isolate, source, static_cast<int>(std::filesystem::file_size(_fileName)))
-			);
-	}
+	/*
+	 * RpCɌ܂Ă֐ (set<֐>("name") œo^)
+	 *
+	 * Ɩ߂l bool/int32_t/uint32_t/float/double ȂAœKꂽ js 璼ڌĂ΂ Fast API ̓
+	 */
+	template<class T>
+	static constexpr bool is_fast_type = std::is_same_v<T, bool> || std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t>
+		|| std::is_same_v<T, float> || std::is_same_v<T, double>;
 
-	v8::Local<v8::Script> compile(std::string& printBuffer, const std::string& source, const std::string& fileName = "", bool doException = false) {
-		useContext(global_context);
-		v8::Local<v8::String> v8_source;
-		v8::Local<v8::String> v8_fileName = as<v8::String>(to_v8(global_isolate, fileName));
-		if ( from_v8<std::string>(global_isolate, v8_fileName).empty() || !read(fileName).ToLocal(&v8_source) ) {
-			v8_source = as<v8::String>(to_v8(global_isolate, source));
-			v8_fileName = as<v8::String>(to_v8(global_isolate, "unnamed"));
-		}
+	template<auto Function, class Signature = decltype(Function)>
+	struct static_function;
+	template<auto Function, class Result, class... Args>
+	struct static_function<Function, Result(*)(Args...)> {
+		static constexpr bool fast = (std::is_void_v<Result> || is_fast_type<Result>) && (is_fast_type<Args> && ...);
 
-		v8::TryCatch tryCatch(global_isolate);
-		v8::ScriptOrigin origin(v8_fileName);
-		v8::Local<v8::Script> script;
+		// ʂ̓ (v8::FunctionCallbackInfo o)
+		static void invoke(const v8::FunctionCallbackInfo<v8::Value>& info) {
+			argument args(const_cast<v8::FunctionCallbackInfo<v8::Value>&>(info));
+			auto function = Function;
+			apply(function, args);
+		}
 
-		if (!v8::Script::Compile(global_isolate->GetCurrentContext(), v8_source, &origin).ToLocal(&script)) {
-			if (doException) {
-				// RpC̗Oœf菈
+#if V8EASY_FAST_API
+		// Fast API ̓ (TurboFan ̂܂ܓnĂ)
+		static Result invoke_fast(v8::Local<v8::Object>, Args... args) {
+			return Function(args...);
+		}
+		static const v8::CFunction* c_function() {
+			if constexpr (fast) {
+				static const v8::CFunction function = v8::CFunction::Make(&invoke_fast);
+				return &function;
 			} else {
-				// Ƃ肠G[eԋpƂ
-				printException(tryCatch, printBuffer);
+				return nullptr;
 			}
-			return v8::Local<v8::Script>();
 		}
+#endif
+	};
 
-		return std::move(script);
-	}
-
-	// v8 ̎s
+	/*
+	 * set() œo^֐̋L^
+	 *
+	 * XibvVbg/鎞 external references ƂēтŕKvɂȂ
+	 */
+	struct binding {
+		std::string key;
+		v8::FunctionCallback callback;
+		// ^t set() ֐IuWFNg ( nullptr)
+		std::shared_ptr<bound_base> data;
+#if V8EASY_FAST_API
+		// set<֐>() œo^ Fast API ̓ ( nullptr)
+		const v8::CFunction* c_function = nullptr;
+#endif
+		binding(const std::string& key, v8::FunctionCallback callback, std::shared_ptr<bound_base> data = nullptr)
+			: key(key), callback(callback), data(std::move(data)) {}
+		// void(v8easy::argument&) ͊֐|C^f[^ɎāA^̍Ă (֐̌^𖳗ςȂ)
+		binding(const std::string& key, v8easy::callback callback)
+			: key(key), callback(&bound_function<v8easy::callback>::invoke), data(std::make_shared<bound_function<v8easy::callback>>(callback)) {}
+	};
+
+private:
+	/*
+	 * vZX1񂾂鏉
+	 *
+	 * V8::Initialize ̓vZX1񂵂ĂׂȂ̂ŁAv8easy Ăŏ1čŌ1j
+	 * (jɂx͂łȂ)
+	 */
+	class engine {
+		inline static std::mutex mutex;
+		inline static size_t count = 0;
+		inline static std::unique_ptr<v8::Platform> platform;
+		inline static std::string path;
+	public:
+		static v8::Platform* acquire(const char* exePath) {
+			std::lock_guard<std::mutex> lock(mutex);
+			if (0 == count++) {
+				/*
+				 V8 rhƍĂȂIvVIׂ邯 {v8_use_external_startup_data = false}
+				łȂ̂ natives_blob.bin/snapshot_blob.bin fBNgw肵ČĂяoKv
+				ڍ:https://groups.google.com/forum/m/#!topic/v8-users/N4GGCkuKnfA
+				*/
+				path = exePath;
+				v8::V8::InitializeICUDefaultLocation(exePath);
+				v8::V8::InitializeExternalStartupData(exePath);
+#if V8EASY_FAST_API && V8_MAJOR_VERSION < 11
+				// set<֐>() œo^֐ TurboFan 璼ڌĂł炤 (11 ͍ŏLŃtO)
+				v8::V8::SetFlagsFromString("--turbo-fast-api-calls");
+#endif
+				// ̏O isolate ̍쐬̂ƂŗOē{
+				platform = v8::platform::NewDefaultPlatform();
+				v8::V8::InitializePlatform(platform.get());
+				v8::V8::Initialize();
+			}
+			return platform.get();
+		}
+		static void release() {
+			std::lock_guard<std::mutex> lock(mutex);
+			if (0 == --count) {
+				v8::V8::Dispose();
+#if V8_MAJOR_VERSION < 10
+				v8::V8::ShutdownPlatform();
+#else
+				v8::V8::DisposePlatform();
+#endif
+				platform.reset();
+			}
+		}
+		static const std::string& exe_path() { return path; }
+	};
+
+public:
+	/*
+	 * ArrayBuffer ̒gmۂ鏊 (ǂꂾgĂ邩𐔂)
+	 *
+	 * Free()  GC ̃XbhĂ΂邱Ƃ̂ŁAg mutex Ŏ
+	 */
+	class allocator : public v8::ArrayBuffer::Allocator {
+	public:
+		struct stats {
+			size_t live_bytes = 0;	// gĂ傫
+			size_t peak_bytes = 0;	// live_bytes ̈ԑ傫
+			uint64_t allocations = 0;
+			uint64_t frees = 0;
+		};
+		stats statistics() {
+			std::lock_guard<std::mutex> lock(mutex);
+			return counter;
+		}
+		// run() I邽тɌĂ΂
+		virtual void run_end() {}
+		// ݒ̐V (isolate_pool ̃XbhƂ1Anullptr Ȃ狤L)
+		virtual std::shared_ptr<allocator> clone() const { return nullptr; }
+
+	protected:
+		std::mutex mutex;
+		stats counter;
+		// mutex ԂŌĂ
+		void count_allocate(size_t length) {
+			counter.live_bytes += length;
+			counter.peak_bytes = std::max(counter.peak_bytes, counter.live_bytes);
+			++counter.allocations;
+		}
+		void count_free(size_t length) {
+			counter.live_bytes -= length;
+			++counter.frees;
+		}
+	};
+
+	/*
+	 * 傫Ƃ (2̗ݏ) āAꂽ̂Ɏg allocator
+	 */
+	class pool_allocator : public allocator {
+		inline static const size_t min_shift = 6;	// 64 oCg
+		inline static const size_t max_shift = 20;	// 1 MB (傫͎̂g񂳂Ȃ)
+		std::array<std::vector<void*>, max_shift - min_shift + 1> free_lists;
+		size_t cached_bytes = 0;
+		const size_t max_cached_bytes;
+
+		static size_t size_class(size_t length) {
+			size_t shift = min_shift;
+			while ((static_cast<size_t>(1) << shift) < length) ++shift;
+			return shift;
+		}
+
+	public:
+		// g񂵗pɎĂ傫̏
+		pool_allocator(size_t max_cached_bytes = 64 * 1024 * 1024) : max_cached_bytes(max_cached_bytes) {}
+		~pool_allocator() {
+			for (auto& list : free_lists)
+				for (auto data : list)
+					std::free(data);
+		}
+		std::shared_ptr<allocator> clone() const override { return std::make_shared<pool_allocator>(max_cached_bytes); }
+
+		void* Allocate(size_t length) override {
+			void* data = AllocateUninitialized(length);
+			if (data) std::memset(data, 0, length);
+			return data;
+		}
+		void* AllocateUninitialized(size_t length) override {
+			size_t shift = size_class(length);
+			std::lock_guard<std::mutex> lock(mutex);
+			void* data = nullptr;
+			if (shift <= max_shift && !free_lists[shift - min_shift].empty()) {
+				data = free_lists[shift - min_shift].back();
+				free_lists[shift - min_shift].pop_back();
+				cached_bytes -= static_cast<size_t>(1) << shift;
+			} else {
+				data = std::malloc(shift <= max_shift ? static_cast<size_t>(1) << shift : length);
+				if (!data) return nullptr;
+			}
+			count_allocate(length);
+			return data;
+		}
+		void Free(void* data, size_t length) override {
+			if (!data) return;
+			size_t shift = size_class(length);
+			std::lock_guard<std::mutex> lock(mutex);
+			count_free(length);
+			if (shift <= max_shift && cached_bytes + (static_cast<size_t>(1) << shift) <= max_cached_bytes) {
+				free_lists[shift - min_shift].push_back(data);
+				cached_bytes += static_cast<size_t>(1) << shift;
+				return;
+			}
+			std::free(data);
+		}
+	};
+
+	/*
+	 * 傫ubN[ɐ؂oĂāArun() Iɂ܂Ƃ߂Ċ߂ allocator
+	 *
+	 * run() ̌ js ŐĂ ArrayBuffer ubŃAꂪ܂Ŏc
+	 */
+	class arena_allocator : public allocator {
+		struct block {
+			std::unique_ptr<char[]> memory;
+			size_t used = 0;
+			size_t live = 0;	// ̃ubN؂oĂ܂ĂȂ
+		};
+		const size_t block_size;
+		// 擪AhXň悤ɂĂ (Free() ̎ɂǂ̃ubNT)
+		std::map<char*, block> blocks;
+		block* current = nullptr;
+
+	public:
+		arena_allocator(size_t block_size = 1024 * 1024) : block_size(block_size) {}
+		~arena_allocator() = default;
+		std::shared_ptr<allocator> clone() const override { return std::make_shared<arena_allocator>(block_size); }
+
+		void* Allocate(size_t length) override {
+			void* data = AllocateUninitialized(length);
+			if (data) std::memset(data, 0, length);
+			return data;
+		}
+		void* AllocateUninitialized(size_t length) override {
+			// ubN 1/4 傫͕̂ʂɊmۂ
+			if (block_size / 4 < length) {
+				void* data = std::malloc(length);
+				if (!data) return nullptr;
+				std::lock_guard<std::mutex> lock(mutex);
+				count_allocate(length);
+				return data;
+			}
+
+			size_t aligned = (length + 15) & ~static_cast<size_t>(15);
+			std::lock_guard<std::mutex> lock(mutex);
+			if (!current || block_size < current->used + aligned) {
+				auto memory = std::make_unique<char[]>(block_size);
+				char* start = memory.get();
+				current = &blocks[start];
+				current->memory = std::move(memory);
+			}
+			void* data = current->memory.get() + current->used;
+			current->used += aligned;
+			++current->live;
+			count_allocate(length);
+			return data;
+		}
+		void Free(void* data, size_t length) override {
+			if (!data) return;
+			if (block_size / 4 < length) {
+				std::free(data);
+				std::lock_guard<std::mutex> lock(mutex);
+				count_free(length);
+				return;
+			}
+
+			std::lock_guard<std::mutex> lock(mutex);
+			count_free(length);
+			auto it = blocks.upper_bound(static_cast<char*>(data));
+			if (blocks.begin() == it) return;
+			auto& owner = (--it)->second;
+			// ؂oĂr̃ubN run_end() Ŋ߂
+			if (0 == --owner.live && &owner != current)
+				blocks.erase(it);
+		}
+		// gIubN܂Ƃ߂Ď̂ĂāÃubN͋Ȃ擪ɖ߂
+		void run_end() override {
+			std::lock_guard<std::mutex> lock(mutex);
+			for (auto it = blocks.begin(); it != blocks.end();) {
+				if (0 == it->second.live && &it->second != current)
+					it = blocks.erase(it);
+				else
+					++it;
+			}
+			if (current && 0 == current->live)
+				current->used = 0;
+		}
+	};
+
+	/*
+	 * v8easy 鎞̐ݒ
+	 */
+	struct options {
+		// nullptr Ȃ V8 ̕Ŵ
+		std::shared_ptr<v8::ArrayBuffer::Allocator> array_buffer_allocator;
+		// q[v̏ (0 Ȃ V8 ̂܂)
+		size_t max_old_space_bytes = 0;
+		size_t max_semi_space_bytes = 0;
+		size_t code_range_bytes = 0;
+		// compile()/execute()/set() ֐/GC ̎Ԃ𐔂 (metrics() œǂ)
+		bool metrics = false;
+		// }CN^XN (Promise  then Ƃ) s邩
+		// (V8 ̂܂ kAuto  js 甲ɎsAkExplicit ɂ run() ̌Ȃǂ v8easy s܂ŗ܂)
+		v8::MicrotasksPolicy microtasks = v8::MicrotasksPolicy::kAuto;
+	};
+
+	/*
+	 * isolate XbhƂ1ĕ js s邽߂̃v[
+	 *
+	 * eXbh͓ bindings (ƃXibvVbg) Ŏ v8easy āAgă^XNs
+	 * isolate ̓Xbh܂Ȃ̂ŁA^XNɂ͎sXbh v8easy n
+	 */
+	class isolate_pool {
+		std::vector<std::thread> workers;
+		std::deque<std::function<void(v8easy&)>> tasks;
+		std::mutex mutex;
+		std::condition_variable condition;
+		bool stopping = false;
+
+		void work(std::vector<binding> bindings, std::string snapshot, size_t snapshotBindings, options settings, std::promise<void> ready) {
+			// v8easy::allocator ̓XbhƂɕʂ̂̂ɂ (arena_allocator  run_end() ő isolate ̕܂Ŋ߂Ȃ悤)
+			if (auto shared = dynamic_cast<allocator*>(settings.array_buffer_allocator.get())) {
+				if (auto own = shared->clone())
+					settings.array_buffer_allocator = std::move(own);
+			}
+			// XibvVbgɓĂ镪nāAォ set() ꂽ͋Nɓ\t
+			snapshotBindings = std::min(snapshotBindings, bindings.size());
+			v8easy js(engine::exe_path().c_str(), std::vector<binding>(bindings.begin(), bindings.begin() + snapshotBindings), snapshot, settings);
+			for (size_t i = snapshotBindings; i < bindings.size(); ++i)
+				js.set(bindings[i]);
+			ready.set_value();
+			while (true) {
+				std::function<void(v8easy&)> task;
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					condition.wait(lock, [this] { return stopping || !tasks.empty(); });
+					if (tasks.empty()) return;
+					task = std::move(tasks.front());
+					tasks.pop_front();
+				}
+				task(js);
+			}
+		}
+
+	public:
+		// snapshotBindings  bindings ̐擪牽XibvVbgɓĂ邩 (͋N set() )
+		// options ̃ftHg options() ɂ GCC ͒ʂȂ (q struct ̏qNX̍Ō܂Ō܂Ȃ) ̂ŕʂɗpӂ
+		isolate_pool(const std::vector<binding>& bindings, const std::string& snapshot = "", size_t threads = std::thread::hardware_concurrency())
+			: isolate_pool(bindings, snapshot, threads, options()) {}
+		isolate_pool(const std::vector<binding>& bindings, const std::string& snapshot, size_t threads, const options& settings, size_t snapshotBindings = SIZE_MAX) {
+			if (0 == threads) threads = 1;
+			for (size_t i = 0; i < threads; ++i) {
+				// isolate oオ܂ő҂Ȃƍŏ̃^XN̎Ԃɍ쐬Ԃ
+				std::promise<void> ready;
+				auto future = ready.get_future();
+				workers.emplace_back(&isolate_pool::work, this, bindings, snapshot, snapshotBindings, settings, std::move(ready));
+				future.wait();
+			}
+		}
+		// cĂ^XNSЕtĂI
+		~isolate_pool() {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				stopping = true;
+			}
+			condition.notify_all();
+			for (auto& worker : workers)
+				worker.join();
+		}
+
+		size_t size() const { return workers.size(); }
+
+		// ǂꂩ̃Xbh task(v8easy&) sČʂ future Ŏ󂯎
+		template<class Task, class Result = std::invoke_result_t<Task, v8easy&>>
+		std::future<Result> submit(Task&& task) {
+			// std::function ̓Rs[łȂƓȂ̂ packaged_task  shared_ptr ŕ
+			auto packaged = std::make_shared<std::packaged_task<Result(v8easy&)>>(std::forward<Task>(task));
+			auto future = packaged->get_future();
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				tasks.emplace_back([packaged](v8easy& js) { (*packaged)(js); });
+			}
+			condition.notify_one();
+			return future;
+		}
+
+		// ǂꂩ̃Xbh run() 
+		std::future<std::string> run_async(const std::string& source, const std::string& fileName = "") {
+			return submit([source, fileName](v8easy& js) { return js.run(source, fileName); });
+		}
+	};
+
+private:
+	v8::Platform* platform;
+	v8::Isolate::CreateParams create_params;
+	// v[̃Xbhɂݒn
+	options settings;
+	// create_params.array_buffer_allocator ̎ (isolate 蒷ȂƑʖ)
+	std::shared_ptr<v8::ArrayBuffer::Allocator> array_buffer_allocator;
+	// ꂪ v8easy::allocator  (run() ̏Im点)
+	allocator* counted_allocator = nullptr;
+
+	v8::Isolate* global_isolate;
+	// ̂ Global Ŏ (Local  run() Ȃǂ̌ĂяoƂ HandleScope ̒Ŏg)
+	v8::Global<v8::ObjectTemplate> global_object;
+	v8::Global<v8::Context> global_context;
+	v8::Global<v8::Function> float64_array_constructor;
+	std::vector<binding> global_bindings;
+	// ۂɓ\t (gNXLȂ timed_callback ŕ񂾂)
+	std::vector<binding> attached_bindings;
+
+	// XibvVbgN blob (isolate 蒷ȂƑʖ)
+	std::string snapshot_blob;
+	v8::StartupData startup_data = { nullptr, 0 };
+	std::vector<intptr_t> external_references;
+	// RXgN^œnꂽ֐̐ (XibvVbgɓ̂͂܂)
+	size_t snapshot_bindings = 0;
+
+	// intern() ōvpeB (Eternal Ȃ̂ isolate I܂ŏȂ)
+	inline static const size_t interned_keys_max = 4096;
+	std::unordered_map<std::string, v8::Eternal<v8::String>> interned_keys;
+
+	// run_async() Ŏgv[ (ŏɎgɍ)
+	std::unique_ptr<isolate_pool> pool;
+	std::mutex pool_mutex;
+
+public:
+	/*
+	 * R[hLbṼqbgƂ (NԂǂꂭ炢k񂾂̖ڈ)
+	 */
+	struct code_cache_stats {
+		uint64_t hit = 0;		// LbVǂ߂
+		uint64_t miss = 0;		// LbV̂ŃRpCč
+		uint64_t reject = 0;	// LbV͂ V8 ɋۂꂽ̂ō蒼
+	};
+
+private:
+	// ȂR[hLbV͎gȂ
+	std::string code_cache_directory;
+	code_cache_stats code_cache_counter;
+
+public:
+	/*
+	 * RpCς݃XNvg̃LbV̏
+	 */
+	struct script_cache_stats {
+		uint64_t hit = 0;
+		uint64_t miss = 0;
+		uint64_t eviction = 0;	// 𒴂Ēǂo
+		size_t entries = 0;
+		size_t bytes = 0;		// ێĂ\[X̑傫̍v (RpC̑傫 V8 Ȃ̂Ŗڈ)
+		double hit_rate() const { return (hit + miss) ? static_cast<double>(hit) / (hit + miss) : 0.0; }
+	};
+
+private:
+	struct script_cache_entry {
+		uint64_t key = 0;
+		size_t bytes = 0;
+		// nbVvĂʕȂ̂ŁA͌̒lƔׂ
+		std::string source;
+		std::string fileName;
+		int64_t fileTime = 0;
+		uintmax_t fileSize = 0;
+		v8::Global<v8::UnboundScript> script;
+		bool same(const script_cache_entry& other) const {
+			return key == other.key && fileTime == other.fileTime && fileSize == other.fileSize
+				&& fileName == other.fileName && source == other.source;
+		}
+	};
+	// OɂقǍŋߎg
+	std::list<script_cache_entry> script_cache_list;
+	std::unordered_map<uint64_t, std::list<script_cache_entry>::iterator> script_cache_index;
+	// max_entries  0 Ȃ疳
+	size_t script_cache_max_entries = 0, script_cache_max_bytes = 0;
+	script_cache_stats script_cache_counter;
+
+public:
+	v8easy(const char* exePath) : v8easy(exePath, {}) {}
+	// bindings  set() ԂōAsnapshot  create_snapshot() ō̂nƂN
+	v8easy(const char* exePath, const std::vector<binding>& bindings, const std::string& snapshot = "") : v8easy(exePath, bindings, snapshot, options()) {}
+	v8easy(const char* exePath, const std::vector<binding>& bindings, const std::string& snapshot, const options& settings) : settings(settings) {
+		platform = engine::acquire(exePath);
+
+		// isolate Ƃz݂Ȃ̂Ȃ js słȂ炵Aisolate ̓}`pɕ쐬ł
+		array_buffer_allocator = settings.array_buffer_allocator;
+		if (!array_buffer_allocator)
+			array_buffer_allocator.reset(v8::ArrayBuffer::Allocator::NewDefaultAllocator());
+		create_params.array_buffer_allocator = array_buffer_allocator.get();
+		counted_allocator = dynamic_cast<allocator*>(array_buffer_allocator.get());
+		set_constraints(create_params.constraints, settings);
+		std::vector<binding> entries;
+		for (auto& entry : bindings)
+			entries.push_back(instrument(entry));
+		if (!snapshot.empty()) {
+			// ƓтŊ֐̃AhXnȂƕłȂ
+			// (XibvVbgɂ͕ޑO̊֐Ă̂ŁAoptions.metrics ƈĂт͓)
+			snapshot_blob = snapshot;
+			startup_data = { snapshot_blob.data(), static_cast<int>(snapshot_blob.size()) };
+			external_references = make_external_references(bindings);
+			create_params.snapshot_blob = &startup_data;
+			create_params.external_references = external_references.data();
+		}
+		snapshot_bindings = bindings.size();
+		global_isolate = v8::Isolate::New(create_params);
+		global_isolate->Enter();
+		// static ȏ isolate  v8easy 悤ɂĂ
+		global_isolate->SetData(isolate_slot(), this);
+		global_isolate->SetMicrotasksPolicy(settings.microtasks);
+		if (settings.metrics) {
+			global_isolate->AddGCPrologueCallback(gc_prologue, this);
+			global_isolate->AddGCEpilogueCallback(gc_epilogue, this);
+		}
+
+		//  global_object (__main__݂Ȃ)ɐFXȊ֐\tĂ
+		{
+			v8::HandleScope handle_scope(global_isolate);
+			auto global = v8::ObjectTemplate::New(global_isolate);
+			for (auto& function : loop_functions)
+				global->Set(intern(global_isolate, function.name), v8::FunctionTemplate::New(global_isolate, function.callback, v8::Boolean::New(global_isolate, function.repeat)));
+			global_object.Reset(global_isolate, global);
+		}
+		for (size_t i = 0; i < bindings.size(); ++i)
+			attach(bindings[i], entries[i]);
+	}
+	~v8easy() {
+		// v[̃Xbh engine gĂ̂ŐɎ~߂
+		pool.reset();
+		// Global  isolate Ă邤ɉȂƑʖ
+		clear_script_cache();
+		clear_module_cache();
+		flush_code_cache();
+		// [̃^XNcĂ炱ŕЕt
+		context_pool_size = 0;
+		while (v8::platform::PumpMessageLoop(platform, global_isolate))
+			continue;
+		pooled_contexts.clear();
+		mapper.Reset();
+		timer_queue = decltype(timer_queue)();
+		timer_tasks.clear();
+		// c荞݂͏̃bZ[W[vōςł̂ŁAŎ~߂Ă
+		watch.reset();
+		if (cpu_profiler || heap_profiling)
+			stop_profiling();
+		global_context.Reset();
+		global_object.Reset();
+		float64_array_constructor.Reset();
+		if (settings.metrics) {
+			global_isolate->RemoveGCPrologueCallback(gc_prologue, this);
+			global_isolate->RemoveGCEpilogueCallback(gc_epilogue, this);
+		}
+		global_isolate->Exit();
+		global_isolate->Dispose();
+		engine::release();
+	}
+
+	// options ̃q[v̏ ResourceConstraints ɓ
+	static void set_constraints(v8::ResourceConstraints& constraints, const options& settings) {
+#if V8_MAJOR_VERSION < 8
+		if (settings.max_old_space_bytes)
+			constraints.set_max_old_space_size(std::max<size_t>(1, settings.max_old_space_bytes / (1024 * 1024)));
+		if (settings.max_semi_space_bytes)
+			constraints.set_max_semi_space_size_in_kb(std::max<size_t>(1, settings.max_semi_space_bytes / 1024));
+		if (settings.code_range_bytes)
+			constraints.set_code_range_size(std::max<size_t>(1, settings.code_range_bytes / (1024 * 1024)));
+#else
+		if (settings.max_old_space_bytes)
+			constraints.set_max_old_generation_size_in_bytes(settings.max_old_space_bytes);
+		if (settings.max_semi_space_bytes)
+			constraints.set_max_young_generation_size_in_bytes(settings.max_semi_space_bytes * 3);
+		if (settings.code_range_bytes)
+			constraints.set_code_range_size_in_bytes(settings.code_range_bytes);
+#endif
+	}
+
+	/*
+	 * options.metrics LȎɐ
+	 */
+	struct metrics_report {
+		histogram compile;
+		histogram execute;
+		histogram gc;
+		std::vector<std::pair<std::string, histogram>> callbacks;
+		// Fast API ̓֐ (œKꂽ js 璼ڌĂ΂ꂽ callbacks ɐȂ)
+		std::vector<std::string> fast_callbacks;
+		v8::HeapStatistics heap;
+		struct heap_space {
+			std::string name;
+			size_t size, used, available, physical;
+		};
+		std::vector<heap_space> spaces;
+
+		// VFŕ\p
+		std::string text() const {
+			// v8::HeapStatistics  getter  const Ȃ̂ŎʂĂǂ
+			auto heap = this->heap;
+			auto ms = [](std::chrono::nanoseconds value) { return std::to_string(value.count() / 1000000.0) + "ms"; };
+			auto line = [&ms](const std::string& name, const histogram& h) {
+				return name + ": count " + std::to_string(h.count) + ", total " + ms(h.total)
+					+ ", mean " + ms(h.mean()) + ", p50 " + ms(h.percentile(0.5)) + ", p99 " + ms(h.percentile(0.99))
+					+ ", max " + ms(h.max) + "\n";
+			};
+			std::string result = line("compile", compile) + line("execute", execute) + line("gc", gc);
+			for (auto& callback : callbacks) {
+				bool fast = fast_callbacks.end() != std::find(fast_callbacks.begin(), fast_callbacks.end(), callback.first);
+				result += line("  " + callback.first + "()" + (fast ? " [Fast API calls not counted]" : ""), callback.second);
+			}
+			result += "heap: used " + std::to_string(heap.used_heap_size()) + " / total " + std::to_string(heap.total_heap_size())
+				+ " / limit " + std::to_string(heap.heap_size_limit()) + ", external " + std::to_string(heap.external_memory()) + "\n";
+			for (auto& space : spaces)
+				result += "  " + space.name + ": used " + std::to_string(space.used) + " / " + std::to_string(space.size) + "\n";
+			return result;
+		}
+	};
+	metrics_report metrics() {
+		metrics_report report;
+		report.compile = compile_metrics;
+		report.execute = execute_metrics;
+		report.gc = gc_metrics;
+		for (auto& callback : callback_metrics)
+			report.callbacks.emplace_back(callback.first, callback.second);
+		report.fast_callbacks = fast_callback_names;
+		global_isolate->GetHeapStatistics(&report.heap);
+		for (size_t i = 0; i < global_isolate->NumberOfHeapSpaces(); ++i) {
+			v8::HeapSpaceStatistics space;
+			if (!global_isolate->GetHeapSpaceStatistics(&space, i)) continue;
+			report.spaces.push_back({
+				space.space_name(), space.space_size(), space.space_used_size(),
+				space.space_available_size(), space.physical_space_size()
+			});
+		}
+		return report;
+	}
+
+private:
+	histogram compile_metrics, execute_metrics, gc_metrics;
+	// set() O (unordered_map ̒g̓AhXςȂ̂ timed_callback ڎw)
+	std::unordered_map<std::string, histogram> callback_metrics;
+	std::vector<std::string> fast_callback_names;
+	std::chrono::steady_clock::time_point gc_start;
+
+	static void gc_prologue(v8::Isolate*, v8::GCType, v8::GCCallbackFlags, void* data) {
+		static_cast<v8easy*>(data)->gc_start = std::chrono::steady_clock::now();
+	}
+	static void gc_epilogue(v8::Isolate*, v8::GCType, v8::GCCallbackFlags, void* data) {
+		auto self = static_cast<v8easy*>(data);
+		self->gc_metrics.record(std::chrono::steady_clock::now() - self->gc_start);
+	}
+
+public:
+	/*
+	 * stop_profiling() ̌ (Chrome DevTools ł̂܂ܓǂ߂ JSON)
+	 */
+	struct profile {
+		std::string cpu;	// .cpuprofile
+		std::string heap;	// .heapprofile
+	};
+
+	// vt@Cn߂ (interval ̓TvO̊Ԋu)
+	void start_profiling(bool cpu = true, bool heap = false, std::chrono::microseconds interval = std::chrono::microseconds(1000)) {
+		if (cpu && !cpu_profiler) {
+			v8::HandleScope handle_scope(global_isolate);
+			cpu_profiler = v8::CpuProfiler::New(global_isolate);
+			cpu_profiler->SetSamplingInterval(static_cast<int>(interval.count()));
+			cpu_profiler->StartProfiling(intern(global_isolate, "v8easy"), true);
+		}
+		if (heap && !heap_profiling) {
+			heap_profiling = global_isolate->GetHeapProfiler()->StartSamplingHeapProfiler();
+		}
+	}
+	// ~߂ČʂԂ (ĂȂ͋󕶎)
+	profile stop_profiling() {
+		profile result;
+		v8::HandleScope handle_scope(global_isolate);
+		if (cpu_profiler) {
+			auto cpu = cpu_profiler->StopProfiling(intern(global_isolate, "v8easy"));
+			if (cpu) {
+				result.cpu = cpu_profile_json(cpu);
+				cpu->Delete();
+			}
+			cpu_profiler->Dispose();
+			cpu_profiler = nullptr;
+		}
+		if (heap_profiling) {
+			auto heapProfiler = global_isolate->GetHeapProfiler();
+			std::unique_ptr<v8::AllocationProfile> heap(heapProfiler->GetAllocationProfile());
+			if (heap) {
+				uint32_t nextId = 0;
+				result.heap = "{\"head\":" + heap_profile_json(heap->GetRootNode(), nextId) + ",\"samples\":[]}";
+			}
+			heapProfiler->StopSamplingHeapProfiler();
+			heap_profiling = false;
+		}
+		return result;
+	}
+
+private:
+	v8::CpuProfiler* cpu_profiler = nullptr;
+	bool heap_profiling = false;
+
+	static std::string json_string(const std::string& value) {
+		std::string result = "\"";
+		for (char c : value) {
+			switch (c) {
+			case '"': result += "\\\""; break;
+			case '\\': result += "\\\\"; break;
+			case '\n': result += "\\n"; break;
+			case '\r': result += "\\r"; break;
+			case '\t': result += "\\t"; break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20) {
+					char escaped[8];
+					std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+					result += escaped;
+				} else {
+					result += c;
+				}
+			}
+		}
+		return result + "\"";
+	}
+	// DevTools ̍s/ 0  (V8  1 AȂ 0)
+	static std::string call_frame_json(const std::string& functionName, int scriptId, const std::string& url, int line, int column) {
+		return "{\"functionName\":" + json_string(functionName)
+			+ ",\"scriptId\":\"" + std::to_string(scriptId) + "\""
+			+ ",\"url\":" + json_string(url)
+			+ ",\"lineNumber\":" + std::to_string(line - 1)
+			+ ",\"columnNumber\":" + std::to_string(column - 1) + "}";
+	}
+
+	static void cpu_node_json(const v8::CpuProfileNode* node, std::string& nodes) {
+		if (1 < nodes.size()) nodes += ",";
+		nodes += "{\"id\":" + std::to_string(node->GetNodeId())
+			+ ",\"callFrame\":" + call_frame_json(
+				node->GetFunctionNameStr(), node->GetScriptId(), node->GetScriptResourceNameStr(),
+				node->GetLineNumber(), node->GetColumnNumber()
+			)
+			+ ",\"hitCount\":" + std::to_string(node->GetHitCount())
+			+ ",\"children\":[";
+		for (int i = 0; i < node->GetChildrenCount(); ++i)
+			nodes += (i ? "," : "") + std::to_string(node->GetChild(i)->GetNodeId());
+		nodes += "]}";
+		for (int i = 0; i < node->GetChildrenCount(); ++i)
+			cpu_node_json(node->GetChild(i), nodes);
+	}
+	static std::string cpu_profile_json(const v8::CpuProfile* profile) {
+		std::string nodes = "[";
+		cpu_node_json(profile->GetTopDownRoot(), nodes);
+		nodes += "]";
+
+		std::string samples, deltas;
+		int64_t last = profile->GetStartTime();
+		for (int i = 0; i < profile->GetSamplesCount(); ++i) {
+			if (i) {
+				samples += ",";
+				deltas += ",";
+			}
+			samples += std::to_string(profile->GetSample(i)->GetNodeId());
+			deltas += std::to_string(profile->GetSampleTimestamp(i) - last);
+			last = profile->GetSampleTimestamp(i);
+		}
+		return "{\"nodes\":" + nodes
+			+ ",\"startTime\":" + std::to_string(profile->GetStartTime())
+			+ ",\"endTime\":" + std::to_string(profile->GetEndTime())
+			+ ",\"samples\":[" + samples + "]"
+			+ ",\"timeDeltas\":[" + deltas + "]}";
+	}
+
+	std::string heap_profile_json(const v8::AllocationProfile::Node* node, uint32_t& nextId) {
+		size_t selfSize = 0;
+		for (auto& allocation : node->allocations)
+			selfSize += allocation.size * allocation.count;
+		std::string result = "{\"callFrame\":" + call_frame_json(
+				from_v8<std::string>(global_isolate, node->name), node->script_id,
+				node->script_name.IsEmpty() ? "" : from_v8<std::string>(global_isolate, node->script_name),
+				node->line_number, node->column_number
+			)
+			+ ",\"selfSize\":" + std::to_string(selfSize)
+			+ ",\"id\":" + std::to_string(++nextId)
+			+ ",\"children\":[";
+		for (size_t i = 0; i < node->children.size(); ++i)
+			result += (i ? "," : "") + heap_profile_json(node->children[i], nextId);
+		return result + "]}";
+	}
+
+public:
+	// ArrayBuffer ̊mۂ̏ (options  v8easy::allocator n)
+	allocator::stats array_buffer_stats() const {
+		return counted_allocator ? counted_allocator->statistics() : allocator::stats();
+	}
+
+private:
+	// run() I allocator ɒm点 (arena_allocator ͂Ŋ߂)
+	void run_end() {
+		if (counted_allocator)
+			counted_allocator->run_end();
+	}
+
+public:
+
+	// run_async() p̃Xbh߂ (܂ł set() ֐eXbh isolate ɂo^)
+	void use_pool(size_t threads = std::thread::hardware_concurrency()) {
+		std::lock_guard<std::mutex> lock(pool_mutex);
+		pool.reset();
+		pool = std::make_unique<isolate_pool>(global_bindings, snapshot_blob, threads, settings, snapshot_bindings);
+	}
+	isolate_pool& async_pool() {
+		std::lock_guard<std::mutex> lock(pool_mutex);
+		if (!pool)
+			pool = std::make_unique<isolate_pool>(global_bindings, snapshot_blob, std::thread::hardware_concurrency(), settings, snapshot_bindings);
+		return *pool;
+	}
+
+	// \[X v[̂ǂꂩ̃XbhŎs (ǂ̃XbhĂł)
+	std::future<std::string> run_async(const std::string& source, const std::string& fileName = "") {
+		return async_pool().run_async(source, fileName);
+	}
+
+	// isolateOقꍇ
+	operator v8::Isolate*() const { return global_isolate; }
+
+	void printException(v8::TryCatch& tryCatch, std::string& printBuffer) {
+		auto message = tryCatch.Message();
+		if (message.IsEmpty()) return;
+		// print {fileName}:line({line}):col({column begin}-{end}): {message}.
+		printBuffer
+			= from_v8<std::string>(v8::Isolate::GetCurrent(), message->GetScriptOrigin().ResourceName() )
+			+":line("+ std::to_string(message->GetLineNumber(v8::Isolate::GetCurrent()->GetCurrentContext()).FromJust() ) +")"
+			+":col("+ std::to_string(message->GetStartColumn()) +"-"+ std::to_string(message->GetEndColumn()) +")"
+			+": "+ from_v8<std::string>(v8::Isolate::GetCurrent(), as<v8::String>(tryCatch.Exception()) );
+	}
+
+	// s/RpCp̃ReLXg (Ăԑ v8::HandleScope JĂ)
+	v8::Local<v8::Context> useContext() {
+		// s/RpCۂɃReLXgKv݂B(ꖈXR[vƓoō쐬ƃň)
+		// TODO: C++ global_object ɓ\tOɍ쐬ēKpƁA
+		// C++ō쐬IuWFNgȂȂ(܂킩)
+		if (global_context.IsEmpty())
+			global_context.Reset(global_isolate, new_context());
+		return global_context.Get(global_isolate);
+	}
+
+	// global_object VReLXg
+	v8::Local<v8::Context> new_context() {
+		if (snapshot_blob.empty())
+			return keep_builtins(v8::Context::New(global_isolate, nullptr, global_object.Get(global_isolate)));
+
+		// XibvVbg̃ftHgReLXg𕜌āAN set() ꂽォ\t
+		// gNXLȂAXibvVbgɓĂޑO̊֐񂾂̂ɓ\ւ
+		// (EH[AbṽXNvgϐɎĂ֐͕ޑÔ܂)
+		auto context = v8::Context::New(global_isolate);
+		for (size_t i = settings.metrics ? 0 : snapshot_bindings; i < attached_bindings.size(); ++i) {
+			context->Global()->Set(
+				context,
+				intern(global_isolate, attached_bindings[i].key),
+				function_template(global_isolate, attached_bindings[i])->GetFunction(context).ToLocalChecked()
+			).FromJust();
+		}
+		for (auto& function : loop_functions) {
+			context->Global()->Set(
+				context,
+				intern(global_isolate, function.name),
+				v8::Function::New(context, function.callback, v8::Boolean::New(global_isolate, function.repeat)).ToLocalChecked()
+			).FromJust();
+		}
+		return keep_builtins(context);
+	}
+	// XNvgOɑgݍ݂̃RXgN^Ă (from_v8_array ŎgAǂ̃ReLXĝ̂ł悤Ɏg)
+	v8::Local<v8::Context> keep_builtins(v8::Local<v8::Context> context) {
+		if (float64_array_constructor.IsEmpty()) {
+			v8::Local<v8::Value> constructor;
+			if (context->Global()->Get(context, intern(global_isolate, "Float64Array")).ToLocal(&constructor) && constructor->IsFunction())
+				float64_array_constructor.Reset(global_isolate, as<v8::Function>(constructor));
+		}
+		return context;
+	}
+
+	/*
+	 * ReLXgv[̏ (Ԃ̓}CNb)
+	 */
+	struct context_pool_stats {
+		uint64_t hit = 0;		// Ă̂n
+		uint64_t miss = 0;		// 󂾂̂ł̏ō
+		uint64_t replenished = 0;	// v[ɍ (use_context_pool() ōŏɖ߂)
+		size_t available = 0;	// v[ɂ鐔
+		// checkout() ɂ
+		double p50 = 0, p90 = 0, p99 = 0;
+		// run_isolated() 1ɂ (checkout Еt܂ŁArŕ[΂)
+		double request_p50 = 0, request_p90 = 0, request_p99 = 0;
+	};
+
+	// uĂReLXg̐߂ (0 Ŏ~߂)
+	void use_context_pool(size_t size) {
+		context_pool_size = size;
+		if (pooled_contexts.size() > size)
+			pooled_contexts.resize(size);
+		replenish_contexts();
+	}
+	context_pool_stats context_pool() const {
+		auto stats = context_pool_counter;
+		stats.available = pooled_contexts.size();
+		stats.p50 = checkout_latency.percentile(0.50);
+		stats.p90 = checkout_latency.percentile(0.90);
+		stats.p99 = checkout_latency.percentile(0.99);
+		stats.request_p50 = request_latency.percentile(0.50);
+		stats.request_p90 = request_latency.percentile(0.90);
+		stats.request_p99 = request_latency.percentile(0.99);
+		return stats;
+	}
+
+	// ܂ȃReLXg1؂ (Ԃl͌Ăԑ v8::HandleScope ɓ)
+	v8::Local<v8::Context> checkout() {
+		auto start = std::chrono::steady_clock::now();
+		v8::Local<v8::Context> context;
+		if (pooled_contexts.empty()) {
+			++context_pool_counter.miss;
+			context = new_context();
+		} else {
+			++context_pool_counter.hit;
+			context = pooled_contexts.back().Get(global_isolate);
+			pooled_contexts.pop_back();
+		}
+
+		checkout_latency.record(std::chrono::steady_clock::now() - start);
+		return context;
+	}
+	// ؂肽ReLXgԂ
+	// O[oϐĂ邩Ȃ̂Ŏg񂳂Ɏ̂Ă
+	// [ run_loop() ̉ɂȎɂ邯ǁAc肪 low-water mark ؂Ă炱1葫
+	// (܂Ƃ߂čƂ̕1 run_isolated() ɑŜŁA1ɏ̂̓ReLXg1܂)
+	void checkin(v8::Local<v8::Context> context) {
+		context->DetachGlobal();
+		global_isolate->ContextDisposedNotification();
+		if (pooled_contexts.size() < context_pool_low())
+			replenish_context();
+	}
+	// v[ use_context_pool() ̐܂Ŗ߂ (ɂȎɌĂł)
+	void replenish_contexts() {
+		while (replenish_context())
+			continue;
+	}
+
+	// ܂ȃReLXgŎs (O[oϐ͑̎sƋLȂ)
+	const std::string run_isolated(const std::string& source, const std::string& fileName = "") {
+		auto start = std::chrono::steady_clock::now();
+		std::string result;
+		{
+			v8::HandleScope handle_scope(global_isolate);
+			auto context = checkout();
+			execute(context, compile(context, result, source, fileName), result);
+			checkin(context);
+		}
+
+		drain();
+		run_end();
+
+		request_latency.record(std::chrono::steady_clock::now() - start);
+		return result;
+	}
+
+private:
+	// 1葫 (܂Ă false)
+	bool replenish_context() {
+		if (context_pool_size <= pooled_contexts.size()) return false;
+		v8::HandleScope handle_scope(global_isolate);
+		pooled_contexts.emplace_back(global_isolate, new_context());
+		++context_pool_counter.replenished;
+		return true;
+	}
+	// 茸 checkin() ł[ (ɂĂɂȂȂ悤)
+	size_t context_pool_low() const { return context_pool_size ? std::max<size_t>(1, context_pool_size / 4) : 0; }
+
+	/*
+	 * ԂV max Ă (imb)
+	 */
+	class latency_ring {
+		inline static const size_t max = 4096;
+		std::vector<uint32_t> samples;
+		size_t next = 0;
+	public:
+		void record(std::chrono::nanoseconds elapsed) {
+			auto sample = static_cast<uint32_t>(std::min<int64_t>(elapsed.count(), UINT32_MAX));
+			if (samples.size() < max)
+				samples.push_back(sample);
+			else
+				samples[next++ % max] = sample;
+		}
+		// rate (0.5 Ƃ 0.99) ̏̒l (}CNb)
+		double percentile(double rate) const {
+			if (samples.empty()) return 0.0;
+			auto sorted = samples;
+			auto nth = sorted.begin() + static_cast<size_t>(rate * (sorted.size() - 1));
+			std::nth_element(sorted.begin(), nth, sorted.end());
+			return *nth / 1000.0;
+		}
+	};
+
+	std::vector<v8::Global<v8::Context>> pooled_contexts;
+	size_t context_pool_size = 0;
+	context_pool_stats context_pool_counter;
+	latency_ring checkout_latency;
+	latency_ring request_latency;
+
+public:
+
+	// external references ͍Ō nullptr Kv
+	static std::vector<intptr_t> make_external_references(const std::vector<binding>& bindings) {
+		std::vector<intptr_t> references;
+		for (auto& entry : bindings) {
+			references.push_back(reinterpret_cast<intptr_t>(entry.callback));
+			// v8::External ɓꂽ|C^ external references ɕׂȂƃXibvVbgɓȂ
+			if (entry.data)
+				references.push_back(reinterpret_cast<intptr_t>(entry.data.get()));
+#if V8EASY_FAST_API
+			// Fast API ͊֐̃AhXƌ^̗Kv
+			if (entry.c_function) {
+				references.push_back(reinterpret_cast<intptr_t>(entry.c_function->GetAddress()));
+				references.push_back(reinterpret_cast<intptr_t>(entry.c_function->GetTypeInfo()));
+			}
+#endif
+		}
+		references.push_back(0);
+		return references;
+	}
+
+	/*
+	 * RXgN^œnꂽ֐ scripts (EH[Abvp) s̏ԂXibvVbgɂ
+	 *
+	 * s󕶎Ԃ printBuffer ɃG[e
+	 * 鎞 v8easy(exePath, т bindings, XibvVbg) ŋN
+	 * (ォ set() ֐͓Ȃ̂ŁANɂx set() Όォ\t)
+	 */
+	std::string create_snapshot(std::string& printBuffer, const std::vector<std::string>& scripts = {}) {
+		// gNXpɕ񂾂̂ external references ̕тς̂ŁAޑÔ̂
+		std::vector<binding> bindings(global_bindings.begin(), global_bindings.begin() + snapshot_bindings);
+		auto references = make_external_references(bindings);
+		v8::StartupData blob = { nullptr, 0 };
+		bool success = true;
+		{
+			// SnapshotCreator ͐p isolate  Enter Ă
+			v8::SnapshotCreator creator(references.data());
+			v8::Isolate* isolate = creator.GetIsolate();
+			{
+				v8::HandleScope handle_scope(isolate);
+				auto global = v8::ObjectTemplate::New(isolate);
+				for (auto& entry : bindings)
+					global->Set(as<v8::String>(to_v8(isolate, entry.key)), function_template(isolate, entry));
+
+				auto context = v8::Context::New(isolate, nullptr, global);
+				v8::Context::Scope context_scope(context);
+				for (auto& script : scripts) {
+					v8::TryCatch tryCatch(isolate);
+					v8::Local<v8::Script> compiled;
+					if (!v8::Script::Compile(context, as<v8::String>(to_v8(isolate, script))).ToLocal(&compiled)
+						|| compiled->Run(context).IsEmpty()) {
+						printException(tryCatch, printBuffer);
+						success = false;
+						break;
+					}
+				}
+				creator.SetDefaultContext(context);
+			}
+			// HandleScope SĂłȂ blob Ȃ
+			blob = creator.CreateBlob(v8::SnapshotCreator::FunctionCodeHandling::kKeep);
+		}
+
+		std::string result;
+		if (success && blob.data)
+			result.assign(blob.data, blob.raw_size);
+		delete[] blob.data;
+		return result;
+	}
+
+	// t@C̑OɂĂ/NH[gO
+	static std::string unquote(const std::string& fileName) {
+		const char* ignores = " \"'";
+		auto begin = fileName.find_first_not_of(ignores);
+		if (std::string::npos == begin) return "";
+		return fileName.substr(begin, fileName.find_last_not_of(ignores) - begin + 1);
+	}
+
+	/*
+	 * t@CǂݍݐpŃɃ}bv
+	 *
+	 * JȂ/̃t@C̎ data()  nullptr
+	 */
+	class mapped_file {
+#ifdef _WIN32
+		HANDLE file = INVALID_HANDLE_VALUE, mapping = nullptr;
+#else
+		int descriptor = -1;
+#endif
+		const char* address = nullptr;
+		size_t length = 0;
+
+	public:
+		mapped_file(const std::string& fileName) {
+#ifdef _WIN32
+			file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+			LARGE_INTEGER size;
+			if (INVALID_HANDLE_VALUE == file || !GetFileSizeEx(file, &size) || 0 == size.QuadPart) return;
+			mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (!mapping) return;
+			address = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+			if (address) length = static_cast<size_t>(size.QuadPart);
+#else
+			descriptor = open(fileName.c_str(), O_RDONLY);
+			struct stat status;
+			if (descriptor < 0 || fstat(descriptor, &status) || 0 == status.st_size) return;
+			void* mapped = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+			if (MAP_FAILED == mapped) return;
+			// 珇ɓǂނƂƂƐǂ݂Ă
+			madvise(mapped, static_cast<size_t>(status.st_size), MADV_SEQUENTIAL);
+			address = static_cast<const char*>(mapped);
+			length = static_cast<size_t>(status.st_size);
+#endif
+		}
+		~mapped_file() {
+#ifdef _WIN32
+			if (address) UnmapViewOfFile(address);
+			if (mapping) CloseHandle(mapping);
+			if (INVALID_HANDLE_VALUE != file) CloseHandle(file);
+#else
+			if (address) munmap(const_cast<char*>(address), length);
+			if (0 <= descriptor) close(descriptor);
+#endif
+		}
+		mapped_file(const mapped_file&) = delete;
+		mapped_file& operator=(const mapped_file&) = delete;
+
+		const char* data() const { return address; }
+		size_t size() const { return length; }
+	};
+
+	/*
+	 * }bvt@Ĉ܂ v8::String ̒gɂ (ASCII ̃t@Cp)
+	 *
+	 * V8 ̂Ă鎞 Dispose()  delete āAŃ}bv
+	 * XNvgLbVR[hLbV̑҂ɓXNvg͂̊ԂƕĂ̂ŁA
+	 * }bv܂܂ƃt@C㏑ꂽɒgςA؂l߂ꂽ SIGBUS ŗ
+	 * t@C̓Rs[Ă}bvA傫t@C̓}bv܂܂Ȃ̂ŎgĂԂ͏Ȃ
+	 */
+	class mapped_source : public v8::String::ExternalOneByteStringResource {
+		std::unique_ptr<mapped_file> file;
+		std::string copied;
+	public:
+		// 菬t@C̓Rs[
+		static constexpr size_t copy_threshold = 1024 * 1024;
+
+		mapped_source(std::unique_ptr<mapped_file> file) : file(std::move(file)) {
+			if (this->file->size() < copy_threshold) {
+				copied.assign(this->file->data(), this->file->size());
+				this->file.reset();
+			}
+		}
+		const char* data() const override { return file ? file->data() : copied.data(); }
+		size_t length() const override { return file ? file->size() : copied.size(); }
+	};
+
+	/*
+	 * UTF-8  UTF-16 ɕϊ̂ v8::String ̒gɂ (ASCII ȊOĂt@Cp)
+	 */
+	class utf16_source : public v8::String::ExternalStringResource {
+		std::vector<uint16_t> buffer;
+	public:
+		utf16_source(const char* source, size_t size) { utf8_to_utf16(source, size, buffer); }
+		const uint16_t* data() const override { return buffer.data(); }
+		size_t length() const override { return buffer.size(); }
+	};
+
+	// S ASCII ǂ (8oCg܂Ƃ߂Č)
+	static bool is_ascii(const char* data, size_t size) {
+		size_t i = 0;
+		uint64_t bits = 0;
+		for (; i + 8 <= size; i += 8) {
+			uint64_t word;
+			std::memcpy(&word, data + i, 8);
+			bits |= word;
+		}
+		for (; i < size; ++i)
+			bits |= static_cast<uint8_t>(data[i]);
+		return 0 == (bits & 0x8080808080808080ull);
+	}
+
+	// UTF-8  UTF-16 ɂ (BOM ͔΂āAĂƂ NewFromUtf8 ƓтƂ U+FFFD ɂ)
+	// 璷ȕ\ATQ[g̕AU+10FFFF 𒴂́AF5-FF ̐擪oCgĂ鈵
+	static void utf8_to_utf16(const char* source, size_t size, std::vector<uint16_t>& dest) {
+		auto bytes = reinterpret_cast<const uint8_t*>(source);
+		size_t i = (3 <= size && 0xEF == bytes[0] && 0xBB == bytes[1] && 0xBF == bytes[2]) ? 3 : 0;
+		dest.clear();
+		dest.reserve(size - i);
+		while (i < size) {
+			uint32_t c = bytes[i];
+			if (c < 0x80) {
+				dest.push_back(static_cast<uint16_t>(c));
+				++i;
+				continue;
+			}
+			// 2oCgڂɋ͈͂͐擪oCgŌ܂
+			size_t follow;
+			uint8_t lower = 0x80, upper = 0xBF;
+			if (0xC2 <= c && c <= 0xDF) {
+				follow = 1;
+				c &= 0x1F;
+			} else if (0xE0 <= c && c <= 0xEF) {
+				follow = 2;
+				if (0xE0 == c) lower = 0xA0;
+				if (0xED == c) upper = 0x9F;
+				c &= 0x0F;
+			} else if (0xF0 <= c && c <= 0xF4) {
+				follow = 3;
+				if (0xF0 == c) lower = 0x90;
+				if (0xF4 == c) upper = 0x8F;
+				c &= 0x07;
+			} else {
+				dest.push_back(0xFFFD);
+				++i;
+				continue;
+			}
+			// rŐ؂ꂽA܂ł̐т܂Ƃ߂ U+FFFD 1ɂ
+			size_t j = 1;
+			for (; j <= follow && i + j < size; ++j) {
+				uint8_t next = bytes[i + j];
+				if (next < lower || upper < next) break;
+				lower = 0x80;
+				upper = 0xBF;
+				c = (c << 6) | (next & 0x3F);
+			}
+			if (j <= follow) {
+				dest.push_back(0xFFFD);
+				i += j;
+				continue;
+			}
+			i += 1 + follow;
+			if (0x10000 <= c) {
+				c -= 0x10000;
+				dest.push_back(static_cast<uint16_t>(0xD800 | (c >> 10)));
+				dest.push_back(static_cast<uint16_t>(0xDC00 | (c & 0x3FF)));
+			} else {
+				dest.push_back(static_cast<uint16_t>(c));
+			}
+		}
+	}
+
+	/*
+	 * v8::String ̒gɂłƂ܂ŗpӂt@C (isolate gȂ̂Ń[J[XbhōĂ)
+	 *
+	 * ASCII Ȃ}bvt@CAłȂ UTF-16 ɕϊ (ǂΓǂ߂Ȃ)
+	 */
+	struct decoded_file {
+		std::unique_ptr<mapped_source> one_byte;
+		std::unique_ptr<utf16_source> two_byte;
+	};
+	static decoded_file decode(const std::string& fileName) {
+		decoded_file result;
+		auto file = std::make_unique<mapped_file>(unquote(fileName));
+		// t@Cǂݍ߂Ȃ / t@CȂ / ̃t@C
+		if (!file->data()) return result;
+
+		if (is_ascii(file->data(), file->size()))
+			result.one_byte = std::make_unique<mapped_source>(std::move(file));
+		else
+			result.two_byte = std::make_unique<utf16_source>(file->data(), file->size());
+		return result;
+	}
+	// decode() ̂ v8 ɂ (g V8 ɓn̂ decoded ͋ɂȂ)
+	v8::MaybeLocal<v8::String> to_string(decoded_file& decoded) {
+		v8::Local<v8::String> v8_source;
+		if (decoded.one_byte) {
+			if (!v8::String::NewExternalOneByte(global_isolate, decoded.one_byte.get()).ToLocal(&v8_source))
+				return v8::MaybeLocal<v8::String>();
+			decoded.one_byte.release();
+		} else if (decoded.two_byte) {
+			if (!v8::String::NewExternalTwoByte(global_isolate, decoded.two_byte.get()).ToLocal(&v8_source))
+				return v8::MaybeLocal<v8::String>();
+			decoded.two_byte.release();
+		} else {
+			return as<v8::String>(to_v8(global_isolate, ""));
+		}
+		return v8_source;
+	}
+
+	// t@C v8 ̎擾
+	// ASCII Ȃ}bvt@C V8 ɒڌāAłȂ UTF-16 ɕϊ̂n (ǂ V8 ̃q[vɂ̓Rs[Ȃ)
+	v8::MaybeLocal<v8::String> read(const std::string& fileName) {
+		auto decoded = decode(fileName);
+		return to_string(decoded);
+	}
+
+	// v8 ̒g FNV-1a ŃnbV (std::string ɈURs[Ȃ悤ɏo)
+	static uint64_t hash(v8::Isolate* isolate, v8::Local<v8::String> value, uint64_t seed = 14695981039346656037ull) {
+		uint16_t buffer[1024];
+		const int length = value->Length();
+		for (int start = 0; start < length; start += 1024) {
+			int written = value->Write(isolate, buffer, start, 1024, v8::String::NO_NULL_TERMINATION);
+			for (int i = 0; i < written; ++i) {
+				seed = (seed ^ (buffer[i] & 0xff)) * 1099511628211ull;
+				seed = (seed ^ (buffer[i] >> 8)) * 1099511628211ull;
+			}
+		}
+		return seed;
+	}
+
+	// R[hLbVLɂ (directory Ȃ疳)
+	void use_code_cache(const std::string& directory) {
+		code_cache_directory = directory;
+		if (!directory.empty()) {
+			std::error_code error;
+			std::filesystem::create_directories(directory, error);
+		}
+	}
+	const code_cache_stats& code_cache() const { return code_cache_counter; }
+
+	// \[X̃nbV V8 ̃o[W/tO(CachedDataVersionTag)LbṼt@C߂
+	std::string code_cache_path(v8::Local<v8::String> v8_source) {
+		char name[64];
+		std::snprintf(name, sizeof(name), "%016llx-%08x.jscache",
+			static_cast<unsigned long long>(hash(global_isolate, v8_source)),
+			static_cast<unsigned int>(v8::ScriptCompiler::CachedDataVersionTag()));
+		return (std::filesystem::path(code_cache_directory) / name).string();
+	}
+
+	// t@C ScriptOrigin (V8 9  isolate v)
+	static v8::ScriptOrigin script_origin([[maybe_unused]] v8::Isolate* isolate, v8::Local<v8::Value> name) {
+#if V8_MAJOR_VERSION < 9
+		return v8::ScriptOrigin(name);
+#else
+		return v8::ScriptOrigin(isolate, name);
+#endif
+	}
+
+	// ReLXgɌѕtÕXNvg (R[hLbVLȂ炱œǂݏ)
+	v8::MaybeLocal<v8::UnboundScript> compile_unbound(v8::Local<v8::String> v8_source, v8::ScriptOrigin& origin) {
+		if (code_cache_directory.empty()) {
+			v8::ScriptCompiler::Source source(v8_source, origin);
+			return v8::ScriptCompiler::CompileUnboundScript(global_isolate, &source);
+		}
+
+		std::string cacheFile = code_cache_path(v8_source);
+		std::ifstream ifs(cacheFile, std::ios::in | std::ios::binary);
+		std::string cached;
+		if (!ifs.fail()) {
+			cached.assign((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+		}
+
+		v8::Local<v8::UnboundScript> script;
+		if (!cached.empty()) {
+			// cached ̎ source 蒷̂ BufferNotOwned œn
+			v8::ScriptCompiler::Source source(v8_source, origin, new v8::ScriptCompiler::CachedData(
+				reinterpret_cast<const uint8_t*>(cached.data()), static_cast<int>(cached.size()),
+				v8::ScriptCompiler::CachedData::BufferNotOwned
+			));
+			if (!v8::ScriptCompiler::CompileUnboundScript(global_isolate, &source, v8::ScriptCompiler::kConsumeCodeCache).ToLocal(&script)) {
+				return v8::MaybeLocal<v8::UnboundScript>();
+			}
+			if (!source.GetCachedData()->rejected) {
+				++code_cache_counter.hit;
+				return script;
+			}
+			// ۂꂽ V8 ʂɃRpCĂĂ̂ŃLbV蒼 (s)
+			++code_cache_counter.reject;
+		} else {
+			++code_cache_counter.miss;
+			v8::ScriptCompiler::Source source(v8_source, origin);
+			if (!v8::ScriptCompiler::CompileUnboundScript(global_isolate, &source).ToLocal(&script)) {
+				return v8::MaybeLocal<v8::UnboundScript>();
+			}
+		}
+
+		// RpCゾƍŏKvȊ֐RpCĂȂ̂ŁALbV1sĂ珑
+		code_cache_pending.emplace_back(v8::Global<v8::UnboundScript>(global_isolate, script), cacheFile);
+		return script;
+	}
+
+private:
+	// ŝ҂ĂR[hLbVXNvg
+	std::vector<std::pair<v8::Global<v8::UnboundScript>, std::string>> code_cache_pending;
+
+	// ̃t@C𑼂̃vZXɓǂ܂Ȃ悤ɈUʖŏĂu
+	static void write_code_cache(v8::Local<v8::UnboundScript> script, const std::string& cacheFile) {
+		std::unique_ptr<v8::ScriptCompiler::CachedData> data(v8::ScriptCompiler::CreateCodeCache(script));
+		if (!data) return;
+		std::string temporary = cacheFile + ".tmp";
+		std::ofstream ofs(temporary, std::ios::out | std::ios::binary | std::ios::trunc);
+		ofs.write(reinterpret_cast<const char*>(data->data), data->length);
+		ofs.close();
+		std::error_code error;
+		if (!ofs.fail()) std::filesystem::rename(temporary, cacheFile, error);
+		if (ofs.fail() || error) std::filesystem::remove(temporary, error);
+	}
+	// script sIŌĂ (sɒxRpCꂽ֐LbVɓ)
+	void flush_code_cache(v8::Local<v8::Script> script) {
+		if (code_cache_pending.empty()) return;
+		auto unbound = script->GetUnboundScript();
+		for (auto it = code_cache_pending.begin(); it != code_cache_pending.end(); ++it) {
+			if (it->first != unbound) continue;
+			write_code_cache(unbound, it->second);
+			code_cache_pending.erase(it);
+			return;
+		}
+	}
+	// 1sȂ̂͂̂܂܏
+	void flush_code_cache() {
+		v8::HandleScope handle_scope(global_isolate);
+		for (auto& pending : code_cache_pending)
+			write_code_cache(pending.first.Get(global_isolate), pending.second);
+		code_cache_pending.clear();
+	}
+
+public:
+
+	// RpCς݃XNvg̃LbVLɂ (maxEntries  0 Ȃ疳)
+	void use_script_cache(size_t maxEntries, size_t maxBytes = SIZE_MAX) {
+		script_cache_max_entries = maxEntries;
+		script_cache_max_bytes = maxBytes;
+		script_cache_shrink();
+	}
+	const script_cache_stats& script_cache() const { return script_cache_counter; }
+	void clear_script_cache() {
+		script_cache_index.clear();
+		script_cache_list.clear();
+		script_cache_counter.entries = script_cache_counter.bytes = 0;
+	}
+
+private:
+	// (source, fileName) LbṼL[At@C͍̎XVƑ傫ďɒǏ]
+	static script_cache_entry script_cache_key(const std::string& source, const std::string& fileName) {
+		script_cache_entry entry;
+		uint64_t seed = 14695981039346656037ull;
+		auto mix = [&seed](const char* data, size_t length) {
+			for (size_t i = 0; i < length; ++i)
+				seed = (seed ^ static_cast<uint8_t>(data[i])) * 1099511628211ull;
+		};
+		entry.bytes = source.size();
+		mix(source.data(), source.size() + 1);
+		mix(fileName.data(), fileName.size());
+
+		std::error_code error;
+		std::string _fileName = unquote(fileName);
+		if (!_fileName.empty()) {
+			entry.fileTime = static_cast<int64_t>(std::filesystem::last_write_time(_fileName, error).time_since_epoch().count());
+			auto size = std::filesystem::file_size(_fileName, error);
+			if (!error) entry.bytes = static_cast<size_t>(entry.fileSize = size);
+			mix(reinterpret_cast<const char*>(&entry.fileTime), sizeof(entry.fileTime));
+			mix(reinterpret_cast<const char*>(&entry.fileSize), sizeof(entry.fileSize));
+		}
+		entry.key = seed;
+		entry.source = source;
+		entry.fileName = fileName;
+		return entry;
+	}
+
+	// L[vĂgႦΊOꈵ
+	v8::MaybeLocal<v8::UnboundScript> script_cache_find(const script_cache_entry& key) {
+		auto found = script_cache_index.find(key.key);
+		if (script_cache_index.end() == found || !found->second->same(key)) {
+			++script_cache_counter.miss;
+			return v8::MaybeLocal<v8::UnboundScript>();
+		}
+		++script_cache_counter.hit;
+		script_cache_list.splice(script_cache_list.begin(), script_cache_list, found->second);
+		return found->second->script.Get(global_isolate);
+	}
+
+	void script_cache_store(script_cache_entry&& entry, v8::Local<v8::UnboundScript> script) {
+		// Փ˂Â͎̂Ă (cƒǂoɐV̍܂ŏĂ܂)
+		auto found = script_cache_index.find(entry.key);
+		if (script_cache_index.end() != found) {
+			script_cache_counter.bytes -= found->second->bytes;
+			--script_cache_counter.entries;
+			script_cache_list.erase(found->second);
+		}
+		entry.script.Reset(global_isolate, script);
+		script_cache_counter.bytes += entry.bytes;
+		script_cache_list.push_front(std::move(entry));
+		script_cache_index[script_cache_list.front().key] = script_cache_list.begin();
+		++script_cache_counter.entries;
+		script_cache_shrink();
+	}
+
+	// 𒴂ĂÂ̂ǂo
+	void script_cache_shrink() {
+		while (!script_cache_list.empty() && (
+			script_cache_max_entries < script_cache_list.size() || script_cache_max_bytes < script_cache_counter.bytes
+		)) {
+			auto& last = script_cache_list.back();
+			script_cache_counter.bytes -= last.bytes;
+			--script_cache_counter.entries;
+			++script_cache_counter.eviction;
+			script_cache_index.erase(last.key);
+			script_cache_list.pop_back();
+		}
+	}
+
+public:
+	// ԂXNvg͌Ăԑ v8::HandleScope ɓ
+	v8::Local<v8::Script> compile(std::string& printBuffer, const std::string& source, const std::string& fileName = "", bool doException = false) {
+		return compile(useContext(), printBuffer, source, fileName, doException);
+	}
+	// context ɌѕtXNvg (checkout() ReLXgp)
+	v8::Local<v8::Script> compile(v8::Local<v8::Context> context, std::string& printBuffer, const std::string& source, const std::string& fileName = "", bool doException = false) {
+		timer measure(settings.metrics ? &compile_metrics : nullptr);
+		v8::Context::Scope context_scope(context);
+
+		//  (source, fileName) Ȃ\͔͂΂ăReLXgɌѕt邾
+		script_cache_entry cacheKey;
+		if (script_cache_max_entries) {
+			cacheKey = script_cache_key(source, fileName);
+			v8::Local<v8::UnboundScript> cached;
+			if (script_cache_find(cacheKey).ToLocal(&cached))
+				return cached->BindToCurrentContext();
+		}
+
+		v8::Local<v8::String> v8_source;
+		v8::Local<v8::String> v8_fileName = as<v8::String>(to_v8(global_isolate, fileName));
+		if ( from_v8<std::string>(global_isolate, v8_fileName).empty() || !read(fileName).ToLocal(&v8_source) ) {
+			v8_source = as<v8::String>(to_v8(global_isolate, source));
+			v8_fileName = as<v8::String>(to_v8(global_isolate, "unnamed"));
+		}
+
+		v8::TryCatch tryCatch(global_isolate);
+		v8::ScriptOrigin origin = script_origin(global_isolate, v8_fileName);
+		v8::Local<v8::UnboundScript> script;
+
+		if (!compile_unbound(v8_source, origin).ToLocal(&script)) {
+			if (doException) {
+				// RpC̗Oœf菈
+			} else {
+				// Ƃ肠G[eԋpƂ
+				printException(tryCatch, printBuffer);
+			}
+			return v8::Local<v8::Script>();
+		}
+
+		if (script_cache_max_entries)
+			script_cache_store(std::move(cacheKey), script);
+		return script->BindToCurrentContext();
+	}
+
+	// v8 ̎s
 	bool execute(v8::Local<v8::Script> script, std::string& printBuffer, bool doException = false) {
+		v8::HandleScope handle_scope(global_isolate);
+		return execute(useContext(), script, printBuffer, doException);
+	}
+	bool execute(v8::Local<v8::Context> context, v8::Local<v8::Script> script, std::string& printBuffer, bool doException = false) {
 		if (script.IsEmpty()) return false;
-		useContext(global_context);
-		v8::Context::Scope context_scope(global_context);
-		v8::HandleScope handle_scope(global_context->GetIsolate());
+		timer measure(settings.metrics ? &execute_metrics : nullptr);
+		v8::HandleScope handle_scope(global_isolate);
+		v8::Context::Scope context_scope(context);
+
+		v8::TryCatch tryCatch(global_isolate);
+		v8::Local<v8::Value> result;
+		bool ran = script->Run(context).ToLocal(&result);
+		flush_code_cache(script);
+		if (!ran) {
+			if (doException) {
+				// RpC̗Oœf菈
+			} else {
+				// Ƃ肠G[eԋpƂ
+				printException(tryCatch, printBuffer);
+			}
+			return false;
+		}
+
+		if (!result->IsUndefined()) {
+			printBuffer = from_v8<std::string>(global_isolate, result);
+		}
+
+		return true;
+	}
+
+	/*
+	 * std::string ̒g v8::String ̒gɂ (傫 JSON Rs[ɓnp)
+	 */
+	class owned_source : public v8::String::ExternalOneByteStringResource {
+		std::string buffer;
+	public:
+		owned_source(std::string&& buffer) : buffer(std::move(buffer)) {}
+		const char* data() const override { return buffer.data(); }
+		size_t length() const override { return buffer.size(); }
+	};
+	// 傫 ASCII  JSON ͊Oɂ
+	static constexpr size_t json_external_min = 64 * 1024;
+
+	// JSON   v8̒l ɂ (JSON.parse(...) ̃XNvggݗĂȂ̂ŃRpCGXP[vȂ)
+	// Ԃl͌Ăԑ v8::HandleScope ɓ
+	v8::MaybeLocal<v8::Value> json_parse(std::string_view json, std::string& printBuffer) {
+		v8::Local<v8::String> v8_json;
+		if (!v8::String::NewFromUtf8(global_isolate, json.data(), v8::NewStringType::kNormal, static_cast<int>(json.size())).ToLocal(&v8_json)) {
+			printBuffer = "json_parse: too long";
+			return v8::MaybeLocal<v8::Value>();
+		}
+		return json_parse(v8_json, printBuffer);
+	}
+	v8::MaybeLocal<v8::Value> json_parse(const char* json, std::string& printBuffer) {
+		return json_parse(std::string_view(json), printBuffer);
+	}
+	// 傲Ɠnꂽ傫 ASCII  JSON  V8 ɂ̂܂܌
+	v8::MaybeLocal<v8::Value> json_parse(std::string&& json, std::string& printBuffer) {
+		if (json.size() < json_external_min || !is_ascii(json.data(), json.size()))
+			return json_parse(std::string_view(json), printBuffer);
+
+		v8::Local<v8::String> v8_json;
+		auto resource = std::make_unique<owned_source>(std::move(json));
+		if (!v8::String::NewExternalOneByte(global_isolate, resource.get()).ToLocal(&v8_json)) {
+			printBuffer = "json_parse: too long";
+			return v8::MaybeLocal<v8::Value>();
+		}
+		resource.release();
+		return json_parse(v8_json, printBuffer);
+	}
+	v8::MaybeLocal<v8::Value> json_parse(v8::Local<v8::String> json, std::string& printBuffer) {
+		auto context = useContext();
+		v8::Context::Scope context_scope(context);
+
+		v8::TryCatch tryCatch(global_isolate);
+		v8::Local<v8::Value> result;
+		if (!v8::JSON::Parse(context, json).ToLocal(&result)) {
+			printException(tryCatch, printBuffer);
+			return v8::MaybeLocal<v8::Value>();
+		}
+		return result;
+	}
+
+	// v8̒l  JSON  ɂ (zQƂ toJSON ̗OŎs "" Ԃ printBuffer ɗR)
+	std::string json_stringify(v8::Local<v8::Value> value, std::string& printBuffer) {
+		v8::Local<v8::String> json;
+		if (!json_stringify(value, json, printBuffer)) return "";
+
+		std::string result(json->Utf8Length(global_isolate), '\0');
+		json->WriteUtf8(global_isolate, result.data(), static_cast<int>(result.size()), nullptr, v8::String::NO_NULL_TERMINATION | v8::String::REPLACE_INVALID_UTF8);
+		return result;
+	}
+	// Ăяõobt@ɒڏ (KvȃoCgԂ̂ŁAcapacity 傫ΉĂȂAs 0)
+	size_t json_stringify(v8::Local<v8::Value> value, char* buffer, size_t capacity, std::string& printBuffer) {
+		v8::Local<v8::String> json;
+		if (!json_stringify(value, json, printBuffer)) return 0;
+
+		size_t length = json->Utf8Length(global_isolate);
+		if (length <= capacity)
+			json->WriteUtf8(global_isolate, buffer, static_cast<int>(length), nullptr, v8::String::NO_NULL_TERMINATION | v8::String::REPLACE_INVALID_UTF8);
+		return length;
+	}
+	bool json_stringify(v8::Local<v8::Value> value, v8::Local<v8::String>& json, std::string& printBuffer) {
+		auto context = useContext();
+		v8::Context::Scope context_scope(context);
+
+		v8::TryCatch tryCatch(global_isolate);
+		if (!v8::JSON::Stringify(context, value).ToLocal(&json)) {
+			printException(tryCatch, printBuffer);
+			return false;
+		}
+		return true;
+	}
+
+	// \[X ̎s
+	const std::string run(const std::string& source, const std::string& fileName = "") {
+		std::string result;
+		{
+			// 1񂲂ƂɃnĥĂ (ƓĂnh܂Ȃ悤)
+			v8::HandleScope handle_scope(global_isolate);
+			v8::Context::Scope context_scope(useContext());
+			v8::Local<v8::Script> script = compile(result, source, fileName);
+			execute(script, result);
+		}
+
+		drain();
+		run_end();
+
+		return result;
+	}
+
+	/*
+	 * t@Cǂ V8 ɓn (ǂłԂɃ[J[Xbhō\͂i)
+	 */
+	class file_stream : public v8::ScriptCompiler::ExternalSourceStream {
+		std::ifstream ifs;
+		bool first = true;
+	public:
+		inline static const size_t chunk_size = 64 * 1024;
+		file_stream(const std::string& fileName) : ifs(fileName, std::ios::in | std::ios::binary) {}
+		size_t GetMoreData(const uint8_t** src) override {
+			if (!ifs) return 0;
+			// n V8  delete[] 
+			auto chunk = new uint8_t[chunk_size];
+			ifs.read(reinterpret_cast<char*>(chunk), chunk_size);
+			size_t length = static_cast<size_t>(ifs.gcount());
+			size_t skip = 0;
+			// read() Ɠ BOM ͔΂ (ʒuƒxRpCō)
+			if (first && 3 <= length && 0xEF == chunk[0] && 0xBB == chunk[1] && 0xBF == chunk[2])
+				skip = 3;
+			first = false;
+			if (length <= skip) {
+				delete[] chunk;
+				return 0;
+			}
+			if (skip)
+				std::memmove(chunk, chunk + skip, length - skip);
+			*src = chunk;
+			return length - skip;
+		}
+	};
+
+	/*
+	 * stream() œǂݍ/RpC̃XNvg (run() ɓnƃRpCÎ҂Ďs)
+	 */
+	class streaming_script {
+		friend class v8easy;
+		std::string fileName;
+		std::unique_ptr<v8::ScriptCompiler::StreamedSource> source;
+		// Ō̎dグɗvŜ̕ ([J[XbhŃRpČɗpӂĂ)
+		std::unique_ptr<decoded_file> decoded;
+		std::future<void> done;
+	public:
+		streaming_script() = default;
+		streaming_script(streaming_script&&) = default;
+		streaming_script& operator=(streaming_script&&) = default;
+		// [J[Xbh source gĂԂ͏Ȃ
+		~streaming_script() {
+			if (done.valid()) done.wait();
+		}
+	};
+
+private:
+	class streaming_task : public v8::Task {
+		std::unique_ptr<v8::ScriptCompiler::ScriptStreamingTask> task;
+		std::string fileName;
+		decoded_file* decoded;
+		std::promise<void> done;
+	public:
+		streaming_task(v8::ScriptCompiler::ScriptStreamingTask* task, const std::string& fileName, decoded_file* decoded, std::promise<void> done)
+			: task(task), fileName(fileName), decoded(decoded), done(std::move(done)) {}
+		void Run() override {
+			task->Run();
+			// ASCII ǂ̂ UTF-16 ւ̕ϊłĂ (isolate ̃XbhłƎs҂)
+			*decoded = decode(fileName);
+			done.set_value();
+		}
+	};
+
+	// R[hLbV/XNvgLbVg̓Xg[~OȂ (ǂ compile() ̒łȂ)
+	bool streaming_bypasses_cache() const {
+		return !code_cache_directory.empty() || script_cache_max_entries;
+	}
+
+	// stream() ̂̃RpCdグ (LbVg͕ʂ compile() )
+	v8::Local<v8::Script> finish(v8::Local<v8::Context> context, streaming_script& script, std::string& printBuffer) {
+		if (script.done.valid()) script.done.wait();
+		if (!script.source || streaming_bypasses_cache())
+			return compile(context, printBuffer, "", script.fileName);
 
+		v8::Local<v8::String> v8_source;
+		if (!to_string(*script.decoded).ToLocal(&v8_source))
+			return v8::Local<v8::Script>();
 		v8::TryCatch tryCatch(global_isolate);
-		v8::Local<v8::Value> result;
-		if (!script->Run(global_isolate->GetCurrentContext()).ToLocal(&result)) {
-			if (doException) {
-				// RpC̗Oœf菈
-			} else {
-				// Ƃ肠G[eԋpƂ
+		v8::ScriptOrigin origin = script_origin(global_isolate, to_v8(global_isolate, script.fileName));
+		v8::Local<v8::Script> compiled;
+		if (!v8::ScriptCompiler::Compile(context, script.source.get(), v8_source, origin).ToLocal(&compiled))
+			printException(tryCatch, printBuffer);
+		return compiled;
+	}
+
+public:
+	// t@C̓ǂݍ݂ƃRpC[J[XbhŎn߂ (Ɏn߂Ă)
+	// R[hLbV/XNvgLbVgĂ鎞̓t@Co邾ŁArun() ̎ɕʂɃRpC
+	streaming_script stream(const std::string& fileName) {
+		streaming_script script;
+		script.fileName = unquote(fileName);
+		if (streaming_bypasses_cache()) return script;
+		script.source = std::make_unique<v8::ScriptCompiler::StreamedSource>(
+			std::make_unique<file_stream>(script.fileName), v8::ScriptCompiler::StreamedSource::UTF8
+		);
+		script.decoded = std::make_unique<decoded_file>();
+
+		std::promise<void> done;
+		script.done = done.get_future();
+#if V8_MAJOR_VERSION < 9
+		auto task = v8::ScriptCompiler::StartStreamingScript(global_isolate, script.source.get());
+#else
+		auto task = v8::ScriptCompiler::StartStreaming(global_isolate, script.source.get());
+#endif
+		platform->CallOnWorkerThread(std::make_unique<streaming_task>(task, script.fileName, script.decoded.get(), std::move(done)));
+		return script;
+	}
+
+	// stream() ̂s
+	const std::string run(streaming_script& script) {
+		std::string result;
+		if (script.fileName.empty()) return result;
+		{
+			v8::HandleScope handle_scope(global_isolate);
+			auto context = useContext();
+			v8::Context::Scope context_scope(context);
+			v8::Local<v8::Script> compiled = finish(context, script, result);
+			if (!compiled.IsEmpty())
+				execute(context, compiled, result);
+		}
+
+		drain();
+		run_end();
+
+		return result;
+	}
+
+	/*
+	 * fileName ̃XNvg̒l (֐)  chunk ̊esʂāAʂ1s output ɑ (VF --map p)
+	 *
+	 * ֐͍ŏ1񂾂RpCĎĂAchunk ͂܂Ƃ߂1 js ɓn js ̒ōsɕ
+	 * ndjson Ȃes JSON.parse ĂnāAʂ JSON.stringify 
+	 * ֐ undefined Ԃs͏o͂Ȃ
+	 */
+	bool map_lines(const std::string& fileName, bool ndjson, std::string_view chunk, std::string& output, std::string& printBuffer) {
+		v8::HandleScope handle_scope(global_isolate);
+		auto context = useContext();
+		v8::Context::Scope context_scope(context);
+		v8::TryCatch tryCatch(global_isolate);
+
+		std::string key = fileName + (ndjson ? ":ndjson" : ":lines");
+		if (mapper.IsEmpty() || mapper_key != key) {
+			mapper.Reset();
+			v8::Local<v8::Script> script = compile(context, printBuffer, "", fileName);
+			v8::Local<v8::Value> function;
+			if (script.IsEmpty()) return false;
+			if (!script->Run(context).ToLocal(&function) || !function->IsFunction()) {
 				printException(tryCatch, printBuffer);
+				if (printBuffer.empty()) printBuffer = fileName + ": script must evaluate to a function";
+				return false;
 			}
-			return false;
+
+			static const char* batch_source =
+				"(function (f, ndjson) {\n"
+				"	return function (chunk) {\n"
+				"		const lines = chunk.split('\\n');\n"
+				"		let out = '';\n"
+				"		for (let i = 0; i < lines.length; ++i) {\n"
+				"			if (ndjson && !lines[i]) continue;\n"
+				"			const result = f(ndjson ? JSON.parse(lines[i]) : lines[i]);\n"
+				"			if (result === undefined) continue;\n"
+				"			out += (ndjson ? JSON.stringify(result) : String(result)) + '\\n';\n"
+				"		}\n"
+				"		return out;\n"
+				"	};\n"
+				"})";
+			v8::Local<v8::Script> wrapper;
+			v8::Local<v8::Value> factory, batch;
+			v8::Local<v8::Value> args[] = { function, v8::Boolean::New(global_isolate, ndjson) };
+			if (!v8::Script::Compile(context, as<v8::String>(to_v8(global_isolate, batch_source))).ToLocal(&wrapper)
+				|| !wrapper->Run(context).ToLocal(&factory)
+				|| !as<v8::Function>(factory)->Call(context, v8::Undefined(global_isolate), 2, args).ToLocal(&batch)) {
+				printException(tryCatch, printBuffer);
+				return false;
+			}
+			mapper.Reset(global_isolate, as<v8::Function>(batch));
+			mapper_key = key;
 		}
 
-		if (!result->IsUndefined()) {
-			printBuffer = from_v8<std::string>(global_isolate, result);
+		v8::Local<v8::String> input;
+		v8::Local<v8::Value> result;
+		if (!v8::String::NewFromUtf8(global_isolate, chunk.data(), v8::NewStringType::kNormal, static_cast<int>(chunk.size())).ToLocal(&input)) {
+			printBuffer = "map_lines: chunk is too long";
+			return false;
+		}
+		v8::Local<v8::Value> args[] = { input };
+		if (!mapper.Get(global_isolate)->Call(context, v8::Undefined(global_isolate), 1, args).ToLocal(&result)) {
+			printException(tryCatch, printBuffer);
+			return false;
 		}
 
+		auto text = as<v8::String>(result);
+		size_t offset = output.size();
+		output.resize(offset + text->Utf8Length(global_isolate));
+		text->WriteUtf8(global_isolate, &output[offset], static_cast<int>(output.size() - offset), nullptr, v8::String::NO_NULL_TERMINATION | v8::String::REPLACE_INVALID_UTF8);
 		return true;
 	}
 
-	// \[X ̎s
-	const std::string run(const std::string& source, const std::string& fileName = "") {
-		useContext(global_context);
-		v8::Context::Scope context_scope(global_context);
+private:
+	// map_lines() ̊֐ (fileName  ndjson ς蒼)
+	v8::Global<v8::Function> mapper;
+	std::string mapper_key;
 
-		std::string result;
-		v8::Local<v8::Script> script = compile(result, source, fileName);
-		bool success = execute(script, result);
+public:
+	/*
+	 * t run() ̏ (0 Ȃ琧Ȃ)
+	 */
+	struct budget {
+		std::chrono::milliseconds wall{ 0 };	// oߎ
+		std::chrono::milliseconds cpu{ 0 };		// sĂXbh CPU 
+		size_t heap = 0;						// sÕq[v̑ (oCg)
+	};
+
+	/*
+	 * t run() ̌
+	 */
+	struct run_result {
+		enum class error { none, exception, wall_time, cpu_time, heap };
+		error reason = error::none;
+		std::string value;		// ̌
+		std::string message;	// O̓e
+		std::chrono::microseconds elapsed{ 0 };
+		// ~߂ƌ߂ĂۂɎ~܂܂ł̎
+		std::chrono::microseconds terminate_latency{ 0 };
+		bool ok() const { return error::none == reason; }
+	};
+
+private:
+	// ̃Xbhg CPU 
+	static std::chrono::nanoseconds thread_cpu_time() {
+#ifdef _WIN32
+		FILETIME creation, exit, kernel, user;
+		GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user);
+		uint64_t ticks
+			= ((static_cast<uint64_t>(kernel.dwHighDateTime) << 32) | kernel.dwLowDateTime)
+			+ ((static_cast<uint64_t>(user.dwHighDateTime) << 32) | user.dwLowDateTime);
+		return std::chrono::nanoseconds(ticks * 100);
+#else
+		timespec now;
+		clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+		return std::chrono::seconds(now.tv_sec) + std::chrono::nanoseconds(now.tv_nsec);
+#endif
+	}
+
+	/*
+	 * 𒴂s TerminateExecution() Ŏ~߂Xbh
+	 *
+	 * oߎԂ͂̃XbhŌāACPU Ԃƃq[v RequestInterrupt() ŎsXbhɌɍs
+	 */
+	class watchdog {
+		v8::Isolate* isolate;
+		std::mutex mutex;
+		std::condition_variable wake;
+		bool stop = false;
+		bool armed = false;
+		// RequestInterrupt() Ă܂ check() Ă΂ĂȂ (C++ ̊֐Ŏ~܂ĂԂɐςݏグȂ悤1)
+		bool interrupt_pending = false;
+		budget limits;
+		std::chrono::steady_clock::time_point deadline;
+		std::chrono::nanoseconds cpu_start{ 0 };
+		size_t heap_start = 0;
+		std::thread thread;
+
+	public:
+		inline static const std::chrono::milliseconds interval{ 1 };
+		run_result::error fired = run_result::error::none;
+		std::chrono::steady_clock::time_point fired_at;
+		// near heap limit ŏグ߂̒l (グĂȂ 0)
+		size_t initial_heap_limit = 0;
+
+		watchdog(v8::Isolate* isolate) : isolate(isolate), thread([this] { loop(); }) {}
+		~watchdog() {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				stop = true;
+			}
+			wake.notify_all();
+			thread.join();
+		}
+
+		// sOɎsXbhŌĂ
+		void arm(const budget& limits) {
+			v8::HeapStatistics heap;
+			isolate->GetHeapStatistics(&heap);
+			auto cpu = thread_cpu_time();
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				this->limits = limits;
+				armed = true;
+				fired = run_result::error::none;
+				initial_heap_limit = 0;
+				deadline = limits.wall.count()
+					? std::chrono::steady_clock::now() + limits.wall
+					: std::chrono::steady_clock::time_point::max();
+				cpu_start = cpu;
+				heap_start = heap.used_heap_size();
+			}
+			wake.notify_all();
+		}
+		// sɌĂ (~߂Ă true)
+		bool disarm() {
+			std::lock_guard<std::mutex> lock(mutex);
+			armed = false;
+			return run_result::error::none != fired;
+		}
+		bool running() {
+			std::lock_guard<std::mutex> lock(mutex);
+			return run_result::error::none == fired;
+		}
+
+		static void check(v8::Isolate* isolate, void* data) {
+			auto self = static_cast<watchdog*>(data);
+			v8::HeapStatistics heap;
+			isolate->GetHeapStatistics(&heap);
+			auto cpu = thread_cpu_time();
+
+			std::lock_guard<std::mutex> lock(self->mutex);
+			self->interrupt_pending = false;
+			if (!self->armed || run_result::error::none != self->fired) return;
+			if (self->limits.cpu.count() && self->limits.cpu <= cpu - self->cpu_start)
+				self->terminate(run_result::error::cpu_time);
+			else if (self->limits.heap && self->heap_start + self->limits.heap < heap.used_heap_size())
+				self->terminate(run_result::error::heap);
+		}
+		// q[vsɂȂ~߂āA~܂܂ł̕グ
+		static size_t near_heap_limit(void* data, size_t current_heap_limit, size_t initial_heap_limit) {
+			auto self = static_cast<watchdog*>(data);
+			std::lock_guard<std::mutex> lock(self->mutex);
+			if (run_result::error::none == self->fired)
+				self->terminate(run_result::error::heap);
+			self->initial_heap_limit = initial_heap_limit;
+			return current_heap_limit + current_heap_limit / 2;
+		}
+
+	private:
+		// mutex ԂŌĂ
+		void terminate(run_result::error reason) {
+			fired = reason;
+			fired_at = std::chrono::steady_clock::now();
+			isolate->TerminateExecution();
+		}
+
+		void loop() {
+			std::unique_lock<std::mutex> lock(mutex);
+			while (!stop) {
+				if (!armed || run_result::error::none != fired) {
+					wake.wait(lock);
+					continue;
+				}
+
+				auto next = deadline;
+				bool poll = limits.cpu.count() || limits.heap;
+				if (poll)
+					next = std::min(next, std::chrono::steady_clock::now() + interval);
+				if (std::chrono::steady_clock::time_point::max() == next)
+					wake.wait(lock);
+				else
+					wake.wait_until(lock, next);
+				if (stop || !armed || run_result::error::none != fired) continue;
+
+				if (deadline <= std::chrono::steady_clock::now())
+					terminate(run_result::error::wall_time);
+				else if (poll && !interrupt_pending) {
+					interrupt_pending = true;
+					isolate->RequestInterrupt(check, this);
+				}
+			}
+		}
+	};
+	std::unique_ptr<watchdog> watch;
+
+	// body(context, buffer) tŎs (body ͐ true Ԃ buffer ɌʂAs buffer ɗO̓e)
+	template<class Body>
+	run_result run_within(const budget& limits, Body body) {
+		if (!watch)
+			watch = std::make_unique<watchdog>(global_isolate);
+
+		run_result result;
+		std::string buffer;
+		bool success = false;
+		auto start = std::chrono::steady_clock::now();
+		global_isolate->AddNearHeapLimitCallback(watchdog::near_heap_limit, watch.get());
+		watch->arm(limits);
+		{
+			v8::HandleScope handle_scope(global_isolate);
+			auto context = useContext();
+			v8::Context::Scope context_scope(context);
+			success = body(context, buffer);
+		}
+
+		// Ɏc}CN^XN^XN̒ŉ
+		if (watch->running())
+			drain();
+
+		auto end = std::chrono::steady_clock::now();
+		bool terminated = watch->disarm();
+		run_end();
+		global_isolate->RemoveNearHeapLimitCallback(watchdog::near_heap_limit, watch->initial_heap_limit);
+		if (terminated) {
+			// ~߂܂܂Ǝ̎s~܂Ă܂
+			global_isolate->CancelTerminateExecution();
+			result.reason = watch->fired;
+			result.terminate_latency = std::chrono::duration_cast<std::chrono::microseconds>(end - watch->fired_at);
+		} else if (!success) {
+			result.reason = run_result::error::exception;
+			result.message = std::move(buffer);
+		} else {
+			result.value = std::move(buffer);
+		}
+		result.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+		return result;
+	}
+
+public:
+	// tŎs (𒴂~߂āAisolate ͂̂܂܎̎sɎg)
+	run_result run(const std::string& source, const std::string& fileName, const budget& limits) {
+		return run_within(limits, [&](v8::Local<v8::Context> context, std::string& buffer) {
+			return execute(context, compile(context, buffer, source, fileName), buffer);
+		});
+	}
+	// stream() ̂tŎs (RpC̎dグ̒ł)
+	run_result run(streaming_script& script, const budget& limits) {
+		return run_within(limits, [&](v8::Local<v8::Context> context, std::string& buffer) {
+			v8::Local<v8::Script> compiled = finish(context, script, buffer);
+			return !compiled.IsEmpty() && execute(context, compiled, buffer);
+		});
+	}
+
+	// }CN^XN V8 ̃^XN҂ɑSЕt (^C}[ run_loop() ŉ)
+	void drain() {
+		do {
+#if V8_MAJOR_VERSION < 8
+			global_isolate->RunMicrotasks();
+#else
+			global_isolate->PerformMicrotaskCheckpoint();
+#endif
+		} while (v8::platform::PumpMessageLoop(platform, global_isolate));
+	}
+
+	// ̃Xbh task  isolate ̃XbhŎsĂ炤 (run_loop() ̒Ŏs)
+	void post(std::function<void(v8easy&)> task) {
+		{
+			std::lock_guard<std::mutex> lock(loop_mutex);
+			posted_tasks.push_back(std::move(task));
+		}
+		loop_wake.notify_one();
+	}
 
-		while(v8::platform::PumpMessageLoop(platform.get(), global_isolate))
+	// ^C}[ post() ꂽ̂Ȃ܂ŉ (͐Qđ҂)
+	// ^C}[̒œꂽO͍Ō̂̂ printBuffer ɓ false Ԃ
+	bool run_loop(std::string& printBuffer) {
+		loop_error.clear();
+		while (loop_once())
 			continue;
+		printBuffer = loop_error;
+		return loop_error.empty();
+	}
+
+	// \[X sāAPromise ԂĂ猈܂ŃCxg[v
+	run_result run_until_settled(const std::string& source, const std::string& fileName = "") {
+		run_result result;
+		auto start = std::chrono::steady_clock::now();
+		{
+			v8::HandleScope handle_scope(global_isolate);
+			auto context = useContext();
+			v8::Context::Scope context_scope(context);
+			v8::TryCatch tryCatch(global_isolate);
+
+			v8::Local<v8::Script> script = compile(context, result.message, source, fileName);
+			v8::Local<v8::Value> value;
+			bool success = false;
+			if (!script.IsEmpty()) {
+				timer measure(settings.metrics ? &execute_metrics : nullptr);
+				success = script->Run(context).ToLocal(&value);
+			}
+			if (!success) {
+				if (!script.IsEmpty()) printException(tryCatch, result.message);
+				result.reason = run_result::error::exception;
+			} else {
+				drain();
+				if (value->IsPromise()) {
+					auto promise = as<v8::Promise>(value);
+					while (v8::Promise::kPending == promise->State() && loop_once())
+						continue;
+					if (v8::Promise::kPending == promise->State()) {
+						result.reason = run_result::error::exception;
+						result.message = "promise never settled";
+					} else if (v8::Promise::kRejected == promise->State()) {
+						result.reason = run_result::error::exception;
+						result.message = from_v8<std::string>(global_isolate, promise->Result());
+					} else {
+						value = promise->Result();
+					}
+				}
+				if (result.ok() && !value->IsUndefined())
+					result.value = from_v8<std::string>(global_isolate, value);
+			}
+		}
+		run_end();
+		result.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+		return result;
+	}
+
+private:
+	/*
+	 * setTimeout()/setInterval() œo^ꂽ
+	 */
+	struct timer_task {
+		v8::Global<v8::Context> context;
+		v8::Global<v8::Function> function;
+		std::vector<v8::Global<v8::Value>> args;
+		std::chrono::milliseconds interval{ 0 };	// 0 Ȃ1񂾂
+	};
+	// ߂Ɏo (clearTimeout() ꂽ̂ timer_tasks ŁA͎oɔ΂)
+	using timer_due = std::pair<std::chrono::steady_clock::time_point, uint64_t>;
+	std::priority_queue<timer_due, std::vector<timer_due>, std::greater<timer_due>> timer_queue;
+	std::unordered_map<uint64_t, timer_task> timer_tasks;
+	uint64_t timer_next_id = 0;
+
+	std::mutex loop_mutex;
+	std::condition_variable loop_wake;
+	std::deque<std::function<void(v8easy&)>> posted_tasks;
+	std::string loop_error;
+	// ^C}[ post()  V8 ̃^XNɍsԊu
+	inline static const std::chrono::milliseconds idle_poll{ 100 };
+
+	// setTimeout(function, ms, ...args) / setInterval(function, ms, ...args)
+	static void set_timer(const v8::FunctionCallbackInfo<v8::Value>& info) {
+		auto isolate = info.GetIsolate();
+		auto self = instance(isolate);
+		if (!self || info.Length() < 1 || !info[0]->IsFunction()) return;
+
+		double delay = 1 < info.Length() ? info[1]->NumberValue(isolate->GetCurrentContext()).FromMaybe(0) : 0;
+		// NaN/Infinity/̐ 0 ɂāA傫̂̓uEUƓ 2^31-1 ~bŎ~߂ (̂܂܃LXgƖ`)
+		if (!std::isfinite(delay) || delay < 0)
+			delay = 0;
+		delay = std::min(delay, static_cast<double>(INT32_MAX));
+		timer_task task;
+		task.context.Reset(isolate, isolate->GetCurrentContext());
+		task.function.Reset(isolate, as<v8::Function>(info[0]));
+		for (int i = 2; i < info.Length(); ++i)
+			task.args.emplace_back(isolate, info[i]);
+		auto wait = std::chrono::milliseconds(static_cast<int64_t>(delay));
+		// 0ms  setInterval ŉ葱Ȃ悤
+		if (info.Data()->IsTrue())
+			task.interval = std::max(wait, std::chrono::milliseconds(1));
+
+		uint64_t id = ++self->timer_next_id;
+		self->timer_tasks.emplace(id, std::move(task));
+		self->timer_queue.emplace(std::chrono::steady_clock::now() + wait, id);
+		info.GetReturnValue().Set(static_cast<double>(id));
+	}
+	static void clear_timer(const v8::FunctionCallbackInfo<v8::Value>& info) {
+		auto isolate = info.GetIsolate();
+		auto self = instance(isolate);
+		if (!self || info.Length() < 1) return;
+		// setTimeout() Ԃ (1 ȏ̐) łȂΉȂ (NaN ͈͊OLXgƖ`)
+		double id = info[0]->NumberValue(isolate->GetCurrentContext()).FromMaybe(0);
+		if (!std::isfinite(id) || id < 1 || static_cast<double>(self->timer_next_id) < id || std::floor(id) != id) return;
+		self->timer_tasks.erase(static_cast<uint64_t>(id));
+	}
+	static void queue_microtask(const v8::FunctionCallbackInfo<v8::Value>& info) {
+		if (info.Length() < 1 || !info[0]->IsFunction()) return;
+		info.GetIsolate()->EnqueueMicrotask(as<v8::Function>(info[0]));
+	}
+
+	// js ɒu֐
+	struct loop_function {
+		const char* name;
+		v8::FunctionCallback callback;
+		bool repeat;
+	};
+	inline static const loop_function loop_functions[] = {
+		{ "setTimeout", set_timer, false },
+		{ "setInterval", set_timer, true },
+		{ "clearTimeout", clear_timer, false },
+		{ "clearInterval", clear_timer, false },
+		{ "queueMicrotask", queue_microtask, false },
+	};
+
+	// ^C}[s (s true)
+	bool run_timers() {
+		bool ran = false;
+		auto now = std::chrono::steady_clock::now();
+		while (!timer_queue.empty() && timer_queue.top().first <= now) {
+			uint64_t id = timer_queue.top().second;
+			timer_queue.pop();
+			auto found = timer_tasks.find(id);
+			if (timer_tasks.end() == found) continue;
+			ran = true;
+
+			v8::HandleScope handle_scope(global_isolate);
+			auto& task = found->second;
+			auto context = task.context.Get(global_isolate);
+			auto function = task.function.Get(global_isolate);
+			std::vector<v8::Local<v8::Value>> args;
+			for (auto& arg : task.args)
+				args.push_back(arg.Get(global_isolate));
+			if (task.interval.count())
+				timer_queue.emplace(now + task.interval, id);
+			else
+				timer_tasks.erase(found);
+
+			v8::Context::Scope context_scope(context);
+			v8::TryCatch tryCatch(global_isolate);
+			if (function->Call(context, context->Global(), static_cast<int>(args.size()), args.data()).IsEmpty())
+				printException(tryCatch, loop_error);
+			drain();
+		}
+		return ran;
+	}
+
+	// Cxg[v1܂킷 (܂҂̂cĂ true)
+	bool loop_once() {
+		std::deque<std::function<void(v8easy&)>> tasks;
+		{
+			std::unique_lock<std::mutex> lock(loop_mutex);
+			// ҂̂ΐQȂ
+			if (timer_tasks.empty() && posted_tasks.empty())
+				return false;
+			// QỎɂȎԂŃReLXgv[1߂ (߂xɗ)
+			if (posted_tasks.empty() && (timer_queue.empty() || std::chrono::steady_clock::now() < timer_queue.top().first)
+				&& pooled_contexts.size() < context_pool_size) {
+				lock.unlock();
+				replenish_context();
+				return true;
+			}
+			// ̃^C}[̊ post() ܂ŐQ (V8 ̃^XN肱ڂȂ悤 idle_poll Ƃɂ͋N)
+			auto until = std::chrono::steady_clock::now() + idle_poll;
+			if (!timer_queue.empty())
+				until = std::min(until, timer_queue.top().first);
+			loop_wake.wait_until(lock, until, [this] { return !posted_tasks.empty(); });
+			tasks.swap(posted_tasks);
+		}
+		for (auto& task : tasks) {
+			task(*this);
+			drain();
+		}
+		run_timers();
+		drain();
+
+		std::lock_guard<std::mutex> lock(loop_mutex);
+		return !timer_tasks.empty() || !posted_tasks.empty();
+	}
+
+public:
+	/*
+	 * ES module ̃LbV̏
+	 */
+	struct module_cache_stats {
+		uint64_t compiled = 0;	// RpC (߂/t@Cς/import 悪ς)
+		uint64_t reused = 0;	// OɃRpĈ̂܂܎g
+		size_t entries = 0;
+	};
+	module_cache_stats module_cache() const {
+		auto stats = module_cache_counter;
+		stats.entries = modules.size();
+		return stats;
+	}
+	void clear_module_cache() {
+		modules.clear();
+		module_paths.clear();
+	}
+
+	/*
+	 * t@C ES module ƂĎs (import t@Cǂ)
+	 *
+	 * RpC module ̓pXƍXVŃLbVāAɌĂ񂾎͕ςt@CRpC
+	 * (V8  module  import Ƃ̌ѕtォςȂ̂ŁAςt@C import Ă鑤ђ)
+	 * import ̃t@C͍\͂ĂԂɕʃXbhŐɓǂł
+	 */
+	run_result run_module(const std::string& fileName) {
+		run_result result;
+		auto start = std::chrono::steady_clock::now();
+		{
+			v8::HandleScope handle_scope(global_isolate);
+			auto context = useContext();
+			v8::Context::Scope context_scope(context);
+
+			v8::Local<v8::Value> value;
+			if (!evaluate_module(context, fileName, result.message, value)) {
+				result.reason = run_result::error::exception;
+			} else {
+				drain();
+				if (!value.IsEmpty() && !value->IsUndefined())
+					result.value = from_v8<std::string>(global_isolate, value);
+			}
+		}
+		run_end();
+		result.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+		return result;
+	}
+	// t ES module ƂĎs (import ̓ǂݍ݂ƃRpC̒ł)
+	run_result run_module(const std::string& fileName, const budget& limits) {
+		return run_within(limits, [&](v8::Local<v8::Context> context, std::string& buffer) {
+			v8::Local<v8::Value> value;
+			if (!evaluate_module(context, fileName, buffer, value)) return false;
+			if (!value.IsEmpty() && !value->IsUndefined())
+				buffer = from_v8<std::string>(global_isolate, value);
+			return true;
+		});
+	}
+
+private:
+	// fileName Ƃ import ǂݍŎs (value ͌Ăԑ v8::HandleScope ɓ)
+	bool evaluate_module(v8::Local<v8::Context> context, const std::string& fileName, std::string& printBuffer, v8::Local<v8::Value>& value) {
+		v8::TryCatch tryCatch(global_isolate);
+		std::string path = module_resolve("", unquote(fileName));
+		std::unordered_map<std::string, bool> visited;
+		std::unordered_map<std::string, std::shared_future<module_source>> prefetch;
+		bool stale = false;
+		if (!load_module(path, visited, prefetch, printBuffer, stale))
+			return false;
+
+		auto module = modules[path].module.Get(global_isolate);
+		timer measure(settings.metrics ? &execute_metrics : nullptr);
+		bool instantiated = v8::Module::kUninstantiated != module->GetStatus()
+#if V8_MAJOR_VERSION < 9
+			|| module->InstantiateModule(context, resolve_module).FromMaybe(false);
+#else
+			|| module->InstantiateModule(context, resolve_module_request).FromMaybe(false);
+#endif
+		if (!instantiated || !module->Evaluate(context).ToLocal(&value)) {
+			printException(tryCatch, printBuffer);
+			return false;
+		}
+		return true;
+	}
+
+	// ʃXbhœǂ񂾃t@C̒g
+	struct module_source {
+		std::filesystem::file_time_type mtime;
+		std::string text;
+		bool found = false;
+	};
+	struct module_entry {
+		std::filesystem::file_time_type mtime;
+		std::string source;		// import 悪ςɓǂݒɌђp
+		std::vector<std::string> dependencies;
+		v8::Global<v8::Module> module;
+	};
+	// KpX
+	std::unordered_map<std::string, module_entry> modules;
+	// resolve_module()  import  module pXp
+	std::unordered_multimap<int, std::string> module_paths;
+	module_cache_stats module_cache_counter;
+
+	// ǂ̃XbhĂł
+	static module_source read_module(const std::string& path) {
+		module_source result;
+		std::error_code error;
+		result.mtime = std::filesystem::last_write_time(path, error);
+		std::ifstream ifs(path, std::ios::in | std::ios::binary);
+		if (error || ifs.fail()) return result;
+		result.text.assign((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+		if (0 == result.text.compare(0, 3, "\xEF\xBB\xBF"))
+			result.text.erase(0, 3);
+		result.found = true;
+		return result;
+	}
+
+	// referrer (̃t@C) 猩 specifier ̃pX (gqČȂ .js tĂ݂)
+	static std::string module_resolve(const std::string& referrer, const std::string& specifier) {
+		namespace fs = std::filesystem;
+		fs::path path = specifier;
+		if (!referrer.empty() && path.is_relative())
+			path = fs::path(referrer).parent_path() / path;
+		std::error_code error;
+		if (!path.has_extension() && !fs::exists(path, error))
+			path += ".js";
+		return fs::weakly_canonical(path, error).string();
+	}
+
+	std::string module_path(v8::Local<v8::Module> module) {
+		auto range = module_paths.equal_range(module->GetIdentityHash());
+		for (auto it = range.first; it != range.second; ++it) {
+			auto found = modules.find(it->second);
+			if (modules.end() != found && found->second.module == module)
+				return it->second;
+		}
+		return "";
+	}
+
+	static v8::ScriptOrigin module_origin(v8::Isolate* isolate, const std::string& path) {
+		auto name = as<v8::String>(to_v8(isolate, path));
+#if V8_MAJOR_VERSION < 9
+		return v8::ScriptOrigin(
+			name, v8::Local<v8::Integer>(), v8::Local<v8::Integer>(), v8::Local<v8::Boolean>(), v8::Local<v8::Integer>(),
+			v8::Local<v8::Value>(), v8::Local<v8::Boolean>(), v8::Local<v8::Boolean>(), v8::True(isolate)
+		);
+#else
+		return v8::ScriptOrigin(isolate, name, 0, 0, false, -1, v8::Local<v8::Value>(), false, false, true);
+#endif
+	}
+
+	static std::vector<std::string> module_requests(v8::Isolate* isolate, v8::Local<v8::Module> module) {
+		std::vector<std::string> result;
+#if V8_MAJOR_VERSION < 9
+		for (int i = 0; i < module->GetModuleRequestsLength(); ++i)
+			result.push_back(from_v8<std::string>(isolate, module->GetModuleRequest(i)));
+#else
+		auto requests = module->GetModuleRequests();
+		for (int i = 0; i < requests->Length(); ++i)
+			result.push_back(from_v8<std::string>(isolate, requests->Get(isolate->GetCurrentContext(), i).As<v8::ModuleRequest>()->GetSpecifier()));
+#endif
+		return result;
+	}
+
+	class prefetch_task : public v8::Task {
+		std::string path;
+		std::promise<module_source> done;
+	public:
+		prefetch_task(const std::string& path, std::promise<module_source> done) : path(path), done(std::move(done)) {}
+		void Run() override { done.set_value(read_module(path)); }
+	};
+
+	// ܂ǂłȂ import  V8 ̃[J[Xbhœǂݎn߂ (import ĂXbh͑₳Ȃ)
+	void prefetch_modules(const std::vector<std::string>& paths, std::unordered_map<std::string, std::shared_future<module_source>>& prefetch) {
+		for (auto& path : paths) {
+			if (prefetch.count(path)) continue;
+			auto found = modules.find(path);
+			std::error_code error;
+			if (modules.end() != found && found->second.mtime == std::filesystem::last_write_time(path, error)) continue;
+			std::promise<module_source> done;
+			prefetch.emplace(path, done.get_future().share());
+			platform->CallOnWorkerThread(std::make_unique<prefetch_task>(path, std::move(done)));
+		}
+	}
+
+	// path Ƃ import KvȕRpC (stale ɂ̓RpCǂ)
+	bool load_module(
+		const std::string& path, std::unordered_map<std::string, bool>& visited,
+		std::unordered_map<std::string, std::shared_future<module_source>>& prefetch, std::string& printBuffer, bool& stale
+	) {
+		auto seen = visited.find(path);
+		if (visited.end() != seen) {
+			// zĂ鎞͓r̂̂̂܂܎g
+			stale = seen->second;
+			return true;
+		}
+		visited.emplace(path, false);
+
+		std::error_code error;
+		auto mtime = std::filesystem::last_write_time(path, error);
+		// import ǂނ modules ɑ̂ŁACe[^ł͂ȂgwĂ
+		auto found = modules.find(path);
+		module_entry* cached = modules.end() != found ? &found->second : nullptr;
+		bool changed = !cached || error || cached->mtime != mtime
+			|| v8::Module::kErrored == cached->module.Get(global_isolate)->GetStatus();
+
+		if (!changed) {
+			// ͕ςĂȂĂAimport 悪ςĂ猋ђ
+			auto dependencies = cached->dependencies;
+			prefetch_modules(dependencies, prefetch);
+			bool childStale = false;
+			for (auto& dependency : dependencies) {
+				bool stale = false;
+				if (!load_module(dependency, visited, prefetch, printBuffer, stale)) return false;
+				childStale |= stale;
+			}
+			if (!childStale) {
+				++module_cache_counter.reused;
+				stale = false;
+				return true;
+			}
+		}
+
+		// \[X͕ʃXbhœǂ񂾂́Aimport 悪ςȂÔ
+		std::string source;
+		if (changed) {
+			auto fetched = prefetch.find(path);
+			auto text = prefetch.end() != fetched ? fetched->second.get() : read_module(path);
+			if (!text.found) {
+				printBuffer = path + ": cannot read module";
+				return false;
+			}
+			mtime = text.mtime;
+			source = std::move(text.text);
+		} else {
+			source = cached->source;
+		}
+
+		v8::TryCatch tryCatch(global_isolate);
+		v8::Local<v8::String> v8_source;
+		v8::Local<v8::Module> module;
+		auto origin = module_origin(global_isolate, path);
+		if (!v8::String::NewFromUtf8(global_isolate, source.data(), v8::NewStringType::kNormal, static_cast<int>(source.size())).ToLocal(&v8_source)) {
+			printBuffer = path + ": module is too large";
+			return false;
+		}
+		v8::ScriptCompiler::Source compileSource(v8_source, origin);
+		if (!v8::ScriptCompiler::CompileModule(global_isolate, &compileSource).ToLocal(&module)) {
+			printException(tryCatch, printBuffer);
+			return false;
+		}
+		++module_cache_counter.compiled;
+
+		auto& entry = modules[path];
+		if (!entry.module.IsEmpty()) {
+			// Â module ͈ȂĂ
+			auto range = module_paths.equal_range(entry.module.Get(global_isolate)->GetIdentityHash());
+			for (auto it = range.first; it != range.second; ++it) {
+				if (it->second == path) {
+					module_paths.erase(it);
+					break;
+				}
+			}
+		}
+		entry.mtime = mtime;
+		entry.source = std::move(source);
+		entry.module.Reset(global_isolate, module);
+		entry.dependencies.clear();
+		for (auto& specifier : module_requests(global_isolate, module))
+			entry.dependencies.push_back(module_resolve(path, specifier));
+		module_paths.emplace(module->GetIdentityHash(), path);
 
-		return std::move(result);
+		// import Sɓǂݎn߂ĂAɃRpC
+		auto dependencies = entry.dependencies;
+		prefetch_modules(dependencies, prefetch);
+		visited[path] = true;
+		for (auto& dependency : dependencies) {
+			bool childStale = false;
+			if (!load_module(dependency, visited, prefetch, printBuffer, childStale)) return false;
+		}
+		stale = true;
+		return true;
+	}
+
+	static v8::MaybeLocal<v8::Module> resolve_module(v8::Local<v8::Context> context, v8::Local<v8::String> specifier, v8::Local<v8::Module> referrer) {
+		auto isolate = context->GetIsolate();
+		auto self = instance(isolate);
+		auto path = module_resolve(self->module_path(referrer), from_v8<std::string>(isolate, specifier));
+		auto found = self->modules.find(path);
+		if (self->modules.end() == found || found->second.module.IsEmpty()) {
+			isolate->ThrowException(v8::Exception::Error(as<v8::String>(to_v8(isolate, "cannot find module " + path))));
+			return v8::MaybeLocal<v8::Module>();
+		}
+		return found->second.module.Get(isolate);
+	}
+#if 9 <= V8_MAJOR_VERSION
+	// V8 9 ͌Â` InstantiateModule() cĂ̂ŁAOɂƊ֐|C^ǂɂĞBɂȂ
+	// import assertions (with { type: ... }) ͌Ȃ̂ŖOtȂ
+	static v8::MaybeLocal<v8::Module> resolve_module_request(v8::Local<v8::Context> context, v8::Local<v8::String> specifier, v8::Local<v8::FixedArray>, v8::Local<v8::Module> referrer) {
+		return resolve_module(context, specifier, referrer);
+	}
+#endif
+
+public:
+	// binding  FunctionTemplate 
+	static v8::Local<v8::FunctionTemplate> function_template(v8::Isolate* isolate, const binding& entry) {
+		v8::Local<v8::Value> data;
+		if (entry.data)
+			data = v8::External::New(isolate, entry.data.get());
+		v8::Local<v8::FunctionTemplate> result;
+#if V8EASY_FAST_API
+		if (entry.c_function) {
+			result = v8::FunctionTemplate::New(
+				isolate, entry.callback, data, v8::Local<v8::Signature>(), 0,
+				v8::ConstructorBehavior::kThrow, v8::SideEffectType::kHasSideEffect, entry.c_function
+			);
+		}
+#endif
+		if (result.IsEmpty())
+			result = v8::FunctionTemplate::New(isolate, entry.callback, data);
+		// ֐ɖOtĂƁAvt@C C++ ̒̎Ԃ̖Oŏo
+		result->SetClassName(intern(isolate, entry.key));
+		return result;
 	}
 
 	// ϐ/֐ `
-	void set(const std::string& key, v8::FunctionCallback info) {
-		global_object->Set(
-			as<v8::String>(to_v8(global_isolate, key)),
-			to_v8(global_isolate, info)
+	void set(const binding& entry) {
+		attach(entry, instrument(entry));
+	}
+
+private:
+	// original ̓v[̃XbhɓnpAentry ͎ۂɓ\t
+	void attach(const binding& original, const binding& entry) {
+		global_bindings.push_back(original);
+		attached_bindings.push_back(entry);
+		v8::HandleScope handle_scope(global_isolate);
+		global_object.Get(global_isolate)->Set(
+			intern(global_isolate, entry.key),
+			function_template(global_isolate, entry)
 		);
 	}
+	// gNXLȂĂяo̎Ԃ𐔂悤ɕ (Fast API ŌĂ΂ꂽ͐Ȃ̂ŖOoĂ)
+	binding instrument(const binding& entry) {
+		if (!settings.metrics) return entry;
+#if V8EASY_FAST_API
+		if (entry.c_function && fast_callback_names.end() == std::find(fast_callback_names.begin(), fast_callback_names.end(), entry.key))
+			fast_callback_names.push_back(entry.key);
+#endif
+		binding timed = entry;
+		timed.callback = &timed_callback::invoke;
+		timed.data = std::make_shared<timed_callback>(entry.callback, entry.data, &callback_metrics[entry.key]);
+		return timed;
+	}
+
+public:
+	void set(const std::string& key, v8::FunctionCallback info, std::shared_ptr<bound_base> data = nullptr) {
+		this->set(binding(key, info, std::move(data)));
+	}
 	void set(const std::string& key, v8easy::callback info) {
-		this->set(key, (v8::FunctionCallback)info);
+		this->set(binding(key, info));
+	}
+	/*
+	 * ֐̌^/߂l̕ϊ߂ēo^
+	 *
+	 * js.set("add", [](double a, double b) { return a + b; });
+	 * js.set("query", [&db](const std::string& sql) { return db.query(sql); });
+	 * Lv`l FunctionTemplate ̃f[^ɓĂ̂ŁAĂяoƂ new ͂Ȃ
+	 * (run_async() ̃v[̂Ă΂̂ŁAԂȂXbhZ[tɂĂ)
+	 */
+	template<class Function, std::enable_if_t<
+		!std::is_convertible_v<Function, v8easy::callback> && !std::is_convertible_v<Function, v8::FunctionCallback>, int> = 0>
+	void set(const std::string& key, Function&& function) {
+		using bound = bound_function<std::decay_t<Function>>;
+		this->set(key, &bound::invoke, std::make_shared<bound>(std::forward<Function>(function)));
+	}
+	/*
+	 * RpCɌ܂Ă֐o^
+	 *
+	 * double mul(double a, double b) { return a * b; }
+	 * js.set<mul>("mul");
+	 * Ɩ߂l bool/int32_t/uint32_t/float/double ȂAœKꂽ js  Fast API ŒڌĂ΂
+	 * (Fast API  V8 ł͕ʂ̌ĂяoɂȂ)
+	 */
+	template<auto Function>
+	void set(const std::string& key) {
+		binding entry(key, &static_function<Function>::invoke);
+#if V8EASY_FAST_API
+		entry.c_function = static_function<Function>::c_function();
+#endif
+		this->set(entry);
+	}
+	// o֐ object Ɍѕtēo^
+	template<class Result, class Class, class... Args>
+	void set(const std::string& key, Result (Class::*method)(Args...), Class* object) {
+		this->set(key, [method, object](Args... args) -> Result { return (object->*method)(std::forward<Args>(args)...); });
+	}
+	template<class Result, class Class, class... Args>
+	void set(const std::string& key, Result (Class::*method)(Args...) const, const Class* object) {
+		this->set(key, [method, object](Args... args) -> Result { return (object->*method)(std::forward<Args>(args)...); });
 	}
 };